@@ -17,18 +17,52 @@ static BOOL DnsCacheInitialized = FALSE;
 #define DnsCacheLock()          do { EnterCriticalSection(&DnsCache.Lock); } while (0)
 #define DnsCacheUnlock()        do { LeaveCriticalSection(&DnsCache.Lock); } while (0)
 
+/* Expired entries are purged from the whole cache every that many additions */
+#define CACHE_PURGE_INTERVAL    64
+
+static
+ULONG
+DnsIntCacheHashName(
+    _In_ LPCWSTR Name)
+{
+    ULONG ulHash = 0;
+
+    /* Names are compared case-insensitively, so must be their hash */
+    while (*Name)
+        ulHash = ulHash * 31 + RtlDowncaseUnicodeChar(*Name++);
+
+    return ulHash % RESOLVER_CACHE_HASH_SIZE;
+}
+
+static
+BOOL
+DnsIntCacheIsEntryExpired(
+    _In_ PRESOLVER_CACHE_ENTRY CacheEntry,
+    _In_ DWORD dwCurrentTime)
+{
+    if (CacheEntry->bHostsFileEntry)
+        return FALSE;
+
+    return (LONG)(dwCurrentTime - CacheEntry->dwExpireTime) >= 0;
+}
+
 VOID
 DnsIntCacheInitialize(VOID)
 {
+    ULONG i;
+
     DPRINT("DnsIntCacheInitialize()\n");
 
     /* Check if we're initialized */
     if (DnsCacheInitialized)
         return;
 
-    /* Initialize the cache lock and namespace list */
+    /* Initialize the cache lock, namespace list and hash table */
     InitializeCriticalSection((LPCRITICAL_SECTION)&DnsCache.Lock);
     InitializeListHead(&DnsCache.RecordList);
+    for (i = 0; i < RESOLVER_CACHE_HASH_SIZE; i++)
+        InitializeListHead(&DnsCache.HashTable[i]);
+    DnsCache.ulAddCount = 0;
     DnsCacheInitialized = TRUE;
 }
 
@@ -55,8 +89,9 @@ DnsIntCacheRemoveEntryItem(PRESOLVER_CACHE_ENTRY CacheEntry)
 {
     DPRINT("DnsIntCacheRemoveEntryItem(%p)\n", CacheEntry);
 
-    /* Remove the entry from the list */
+    /* Remove the entry from the list and its hash bucket */
     RemoveEntryList(&CacheEntry->CacheLink);
+    RemoveEntryList(&CacheEntry->HashLink);
 
     /* Free record */
     DnsRecordListFree(CacheEntry->Record, DnsFreeRecordList);
@@ -107,22 +142,24 @@ DnsIntFlushCacheEntry(
     _In_ LPCWSTR pszName,
     _In_ WORD wType)
 {
-    PLIST_ENTRY Entry, NextEntry;
+    PLIST_ENTRY Bucket, Entry, NextEntry;
     PRESOLVER_CACHE_ENTRY CacheEntry;
 
     DPRINT("DnsIntFlushCacheEntry(%S %x)\n", pszName, wType);
 
+    Bucket = &DnsCache.HashTable[DnsIntCacheHashName(pszName)];
+
     /* Lock the cache */
     DnsCacheLock();
 
-    /* Loop every entry */
-    Entry = DnsCache.RecordList.Flink;
-    while (Entry != &DnsCache.RecordList)
+    /* Loop every entry of the name's bucket */
+    Entry = Bucket->Flink;
+    while (Entry != Bucket)
     {
         NextEntry = Entry->Flink;
 
         /* Get this entry */
-        CacheEntry = CONTAINING_RECORD(Entry, RESOLVER_CACHE_ENTRY, CacheLink);
+        CacheEntry = CONTAINING_RECORD(Entry, RESOLVER_CACHE_ENTRY, HashLink);
 
         /* Remove it from the list */
         if ((_wcsicmp(CacheEntry->Record->pName, pszName) == 0) &&
@@ -155,7 +192,8 @@ DnsIntCacheGetEntryByName(
 {
     DNS_STATUS Status = DNS_INFO_NO_RECORDS;
     PRESOLVER_CACHE_ENTRY CacheEntry;
-    PLIST_ENTRY NextEntry;
+    PLIST_ENTRY Bucket, NextEntry;
+    DWORD dwCurrentTime;
 
     DPRINT("DnsIntCacheGetEntryByName(%S %hu 0x%lx %p)\n",
            Name, wType, dwFlags, Record);
@@ -163,26 +201,36 @@ DnsIntCacheGetEntryByName(
     /* Assume failure */
     *Record = NULL;
 
+    Bucket = &DnsCache.HashTable[DnsIntCacheHashName(Name)];
+    dwCurrentTime = GetTickCount();
+
     /* Lock the cache */
     DnsCacheLock();
 
-    /* Match the Id with all the entries in the List */
-    NextEntry = DnsCache.RecordList.Flink;
-    while (NextEntry != &DnsCache.RecordList)
+    /* Match the name and type with the entries of the name's bucket */
+    NextEntry = Bucket->Flink;
+    while (NextEntry != Bucket)
     {
         /* Get the Current Entry */
-        CacheEntry = CONTAINING_RECORD(NextEntry, RESOLVER_CACHE_ENTRY, CacheLink);
+        CacheEntry = CONTAINING_RECORD(NextEntry, RESOLVER_CACHE_ENTRY, HashLink);
+        NextEntry = NextEntry->Flink;
 
-        /* Check if this is the Catalog Entry ID we want */
-        if (_wcsicmp(CacheEntry->Record->pName, Name) == 0)
+        if (_wcsicmp(CacheEntry->Record->pName, Name) != 0 ||
+            (wType != DNS_TYPE_ANY && CacheEntry->wType != wType))
+            continue;
+
+        /* Drop it if its time to live is over */
+        if (DnsIntCacheIsEntryExpired(CacheEntry, dwCurrentTime))
         {
-            /* Copy the entry and return it */
-            *Record = DnsRecordSetCopyEx(CacheEntry->Record, DnsCharSetUnicode, DnsCharSetUnicode);
-            Status = ERROR_SUCCESS;
-            break;
+            DPRINT("Entry %S %hu expired\n", Name, CacheEntry->wType);
+            DnsIntCacheRemoveEntryItem(CacheEntry);
+            continue;
         }
 
-        NextEntry = NextEntry->Flink;
+        /* Copy the entry and return it */
+        *Record = DnsRecordSetCopyEx(CacheEntry->Record, DnsCharSetUnicode, DnsCharSetUnicode);
+        Status = ERROR_SUCCESS;
+        break;
     }
 
     /* Release the cache */
@@ -196,19 +244,21 @@ DnsIntCacheRemoveEntryByName(LPCWSTR Name)
 {
     BOOL Ret = FALSE;
     PRESOLVER_CACHE_ENTRY CacheEntry;
-    PLIST_ENTRY NextEntry;
+    PLIST_ENTRY Bucket, NextEntry;
 
     DPRINT("DnsIntCacheRemoveEntryByName(%S)\n", Name);
 
+    Bucket = &DnsCache.HashTable[DnsIntCacheHashName(Name)];
+
     /* Lock the cache */
     DnsCacheLock();
 
-    /* Match the Id with all the entries in the List */
-    NextEntry = DnsCache.RecordList.Flink;
-    while (NextEntry != &DnsCache.RecordList)
+    /* Match the name with the entries of its bucket */
+    NextEntry = Bucket->Flink;
+    while (NextEntry != Bucket)
     {
         /* Get the Current Entry */
-        CacheEntry = CONTAINING_RECORD(NextEntry, RESOLVER_CACHE_ENTRY, CacheLink);
+        CacheEntry = CONTAINING_RECORD(NextEntry, RESOLVER_CACHE_ENTRY, HashLink);
 
         /* Check if this is the Catalog Entry ID we want */
         if (_wcsicmp(CacheEntry->Record->pName, Name) == 0)
@@ -234,7 +284,10 @@ DnsIntCacheAddEntry(
     _In_ PDNS_RECORDW Record,
     _In_ BOOL bHostsFileEntry)
 {
-    PRESOLVER_CACHE_ENTRY Entry;
+    PRESOLVER_CACHE_ENTRY Entry, CacheEntry;
+    PLIST_ENTRY NextEntry;
+    PDNS_RECORDW CurrentRecord;
+    DWORD dwTtl, dwCurrentTime;
 
     DPRINT("DnsIntCacheAddEntry(%p %u)\n",
            Record, bHostsFileEntry);
@@ -242,19 +295,55 @@ DnsIntCacheAddEntry(
     DPRINT("Name: %S\n", Record->pName);
     DPRINT("TTL: %lu\n", Record->dwTtl);
 
-    /* Lock the cache */
-    DnsCacheLock();
+    /* The set lives as long as its shortest-lived record */
+    dwTtl = Record->dwTtl;
+    for (CurrentRecord = Record->pNext; CurrentRecord; CurrentRecord = CurrentRecord->pNext)
+        dwTtl = min(dwTtl, CurrentRecord->dwTtl);
+
+    /* Nothing to cache */
+    if (dwTtl == 0 && !bHostsFileEntry)
+        return;
+
+    /* Make sure the expiry time stays in the range of GetTickCount() arithmetic */
+    dwTtl = min(dwTtl, MAXLONG / 1000);
 
-    /* Match the Id with all the entries in the List */
     Entry = (PRESOLVER_CACHE_ENTRY)HeapAlloc(GetProcessHeap(), 0, sizeof(*Entry));
     if (!Entry)
         return;
 
-    Entry->bHostsFileEntry = bHostsFileEntry;
     Entry->Record = DnsRecordSetCopyEx(Record, DnsCharSetUnicode, DnsCharSetUnicode);
+    if (!Entry->Record)
+    {
+        HeapFree(GetProcessHeap(), 0, Entry);
+        return;
+    }
+
+    dwCurrentTime = GetTickCount();
+    Entry->bHostsFileEntry = bHostsFileEntry;
+    Entry->wType = Record->wType;
+    Entry->dwExpireTime = dwCurrentTime + dwTtl * 1000;
+
+    /* Lock the cache */
+    DnsCacheLock();
+
+    /* Get rid of the entries nobody asked for until they expired */
+    if (++DnsCache.ulAddCount % CACHE_PURGE_INTERVAL == 0)
+    {
+        NextEntry = DnsCache.RecordList.Flink;
+        while (NextEntry != &DnsCache.RecordList)
+        {
+            CacheEntry = CONTAINING_RECORD(NextEntry, RESOLVER_CACHE_ENTRY, CacheLink);
+            NextEntry = NextEntry->Flink;
+
+            if (DnsIntCacheIsEntryExpired(CacheEntry, dwCurrentTime))
+                DnsIntCacheRemoveEntryItem(CacheEntry);
+        }
+    }
 
-    /* Insert it to our List */
+    /* Insert it to our List and to its hash bucket */
     InsertTailList(&DnsCache.RecordList, &Entry->CacheLink);
+    InsertTailList(&DnsCache.HashTable[DnsIntCacheHashName(Entry->Record->pName)],
+                   &Entry->HashLink);
 
     /* Release the cache */
     DnsCacheUnlock();
@@ -24,16 +24,23 @@
 
 #include <strsafe.h>
 
+#define RESOLVER_CACHE_HASH_SIZE 256
+
 typedef struct _RESOLVER_CACHE_ENTRY
 {
     LIST_ENTRY CacheLink;
+    LIST_ENTRY HashLink;
     BOOL bHostsFileEntry;
+    WORD wType;
+    DWORD dwExpireTime;
     PDNS_RECORDW Record;
 } RESOLVER_CACHE_ENTRY, *PRESOLVER_CACHE_ENTRY;
 
 typedef struct _RESOLVER_CACHE
 {
     LIST_ENTRY RecordList;
+    LIST_ENTRY HashTable[RESOLVER_CACHE_HASH_SIZE];
+    ULONG ulAddCount;
     CRITICAL_SECTION Lock;
 } RESOLVER_CACHE, *PRESOLVER_CACHE;
 
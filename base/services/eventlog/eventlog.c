@@ -103,6 +103,9 @@ ServiceControlHandler(DWORD dwControl,
                             0,
                             EVENT_EventlogStopped, 0, NULL, 0, NULL);
 
+            /* Commit the pending records, the system is going down */
+            LogfFlushAll();
+
             UpdateServiceStatus(SERVICE_STOPPED);
             return ERROR_SUCCESS;
 
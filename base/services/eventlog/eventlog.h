@@ -38,6 +38,8 @@ typedef struct _LOGFILE
     WCHAR *LogName;
     RTL_RESOURCE Lock;
     BOOL Permanent;
+    DWORD LastFlushTime;
+    HANDLE FlushTimer;      /* Commits the records left pending by LogfWriteRecord */
     LIST_ENTRY ListEntry;
 } LOGFILE, *PLOGFILE;
 
@@ -102,6 +104,8 @@ LogfClose(PLOGFILE LogFile,
 
 VOID LogfCloseAll(VOID);
 
+VOID LogfFlushAll(VOID);
+
 NTSTATUS
 LogfClearFile(PLOGFILE LogFile,
               PUNICODE_STRING BackupFileName);
@@ -17,6 +17,12 @@
 #define NDEBUG
 #include <debug.h>
 
+/*
+ * Minimal interval, in milliseconds, between two flushes of a log file.
+ * The records written in the meantime are committed together.
+ */
+#define LOGFILE_FLUSH_INTERVAL  1000
+
 /* LOG FILE LIST - GLOBALS ***************************************************/
 
 static LIST_ENTRY LogFileListHead;
@@ -428,6 +434,8 @@ VOID
 LogfClose(PLOGFILE LogFile,
           BOOLEAN  ForceClose)
 {
+    HANDLE FlushTimer;
+
     if (LogFile == NULL)
         return;
 
@@ -436,6 +444,21 @@ LogfClose(PLOGFILE LogFile,
 
     RtlAcquireResourceExclusive(&LogFile->Lock, TRUE);
 
+    /*
+     * Cancel the deferred flush. The timer callback takes the log lock,
+     * so wait for it to complete with the lock released.
+     */
+    while (LogFile->FlushTimer != NULL)
+    {
+        FlushTimer = LogFile->FlushTimer;
+        LogFile->FlushTimer = NULL;
+        RtlReleaseResource(&LogFile->Lock);
+
+        DeleteTimerQueueTimer(NULL, FlushTimer, INVALID_HANDLE_VALUE);
+
+        RtlAcquireResourceExclusive(&LogFile->Lock, TRUE);
+    }
+
     LogfListRemoveItem(LogFile);
 
     ElfCloseFile(&LogFile->LogFile);
@@ -463,6 +486,33 @@ VOID LogfCloseAll(VOID)
     DeleteCriticalSection(&LogFileListCs);
 }
 
+VOID LogfFlushAll(VOID)
+{
+    PLIST_ENTRY CurrentEntry;
+    PLOGFILE Item;
+
+    EnterCriticalSection(&LogFileListCs);
+
+    CurrentEntry = LogFileListHead.Flink;
+    while (CurrentEntry != &LogFileListHead)
+    {
+        Item = CONTAINING_RECORD(CurrentEntry, LOGFILE, ListEntry);
+
+        /* Commit the records not yet flushed to disk */
+        RtlAcquireResourceExclusive(&Item->Lock, TRUE);
+        if (Item->LogFile.FlushPending)
+        {
+            ElfFlushFile(&Item->LogFile);
+            Item->LastFlushTime = GetTickCount();
+        }
+        RtlReleaseResource(&Item->Lock);
+
+        CurrentEntry = CurrentEntry->Flink;
+    }
+
+    LeaveCriticalSection(&LogFileListCs);
+}
+
 NTSTATUS
 LogfClearFile(PLOGFILE LogFile,
               PUNICODE_STRING BackupFileName)
@@ -854,6 +904,37 @@ Quit:
     return Status;
 }
 
+static
+VOID CALLBACK
+LogfpFlushTimerCallback(IN PVOID lpParameter,
+                        IN BOOLEAN TimerOrWaitFired)
+{
+    PLOGFILE LogFile = (PLOGFILE)lpParameter;
+    NTSTATUS Status;
+
+    UNREFERENCED_PARAMETER(TimerOrWaitFired);
+
+    RtlAcquireResourceExclusive(&LogFile->Lock, TRUE);
+
+    /* LogfClose() cleared the handle if it is already deleting the timer */
+    if (LogFile->FlushTimer != NULL)
+    {
+        DeleteTimerQueueTimer(NULL, LogFile->FlushTimer, NULL);
+        LogFile->FlushTimer = NULL;
+    }
+
+    /* Commit the records written since the last flush */
+    if (LogFile->LogFile.FlushPending)
+    {
+        Status = ElfFlushFile(&LogFile->LogFile);
+        if (!NT_SUCCESS(Status))
+            DPRINT1("ElfFlushFile() failed (Status 0x%08lx)\n", Status);
+        LogFile->LastFlushTime = GetTickCount();
+    }
+
+    RtlReleaseResource(&LogFile->Lock);
+}
+
 NTSTATUS
 LogfWriteRecord(PLOGFILE LogFile,
                 PEVENTLOGRECORD Record,
@@ -861,6 +942,7 @@ LogfWriteRecord(PLOGFILE LogFile,
 {
     NTSTATUS Status;
     LARGE_INTEGER SystemTime;
+    DWORD Elapsed;
 
     // ASSERT(sizeof(*Record) == sizeof(RecBuf));
 
@@ -878,12 +960,57 @@ LogfWriteRecord(PLOGFILE LogFile,
     RtlTimeToSecondsSince1970(&SystemTime, &Record->TimeWritten);
 
     Status = ElfWriteRecord(&LogFile->LogFile, Record, BufSize);
+    Elapsed = GetTickCount() - LogFile->LastFlushTime;
     if (Status == STATUS_LOG_FILE_FULL)
     {
         /* The event log file is full, queue a message box for the user and exit */
         // TODO!
         DPRINT1("Log file `%S' is full!\n", LogFile->LogName);
     }
+    else if (NT_SUCCESS(Status) && Elapsed < LOGFILE_FLUSH_INTERVAL)
+    {
+        /*
+         * The record stays pending until the next flush. Make sure it is
+         * committed within the interval even if no other record follows.
+         */
+        if (LogFile->LogFile.FlushPending && LogFile->FlushTimer == NULL &&
+            !CreateTimerQueueTimer(&LogFile->FlushTimer,
+                                   NULL,
+                                   LogfpFlushTimerCallback,
+                                   LogFile,
+                                   LOGFILE_FLUSH_INTERVAL - Elapsed,
+                                   0,
+                                   WT_EXECUTEONLYONCE))
+        {
+            DPRINT1("CreateTimerQueueTimer() failed (Error %lu)\n", GetLastError());
+            LogFile->FlushTimer = NULL;
+
+            /* Commit the record right away instead */
+            Status = ElfFlushFile(&LogFile->LogFile);
+            if (!NT_SUCCESS(Status))
+            {
+                DPRINT1("ElfFlushFile() failed (Status 0x%08lx)\n", Status);
+                Status = STATUS_EVENTLOG_FILE_CORRUPT;
+            }
+            LogFile->LastFlushTime = GetTickCount();
+        }
+    }
+    else if (NT_SUCCESS(Status))
+    {
+        /*
+         * Do not flush the log file for each record, but commit all the
+         * records written since the last flush at once. The log header
+         * stays dirty on disk in the meantime, so that the log can be
+         * recovered should we not get a chance to flush it.
+         */
+        Status = ElfFlushFile(&LogFile->LogFile);
+        if (!NT_SUCCESS(Status))
+        {
+            DPRINT1("ElfFlushFile() failed (Status 0x%08lx)\n", Status);
+            Status = STATUS_EVENTLOG_FILE_CORRUPT;
+        }
+        LogFile->LastFlushTime = GetTickCount();
+    }
 
     /* Unlock the log file */
     RtlReleaseResource(&LogFile->Lock);
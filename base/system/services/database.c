@@ -37,6 +37,9 @@ static DWORD ServiceTag = 0;
 static CRITICAL_SECTION ControlServiceCriticalSection;
 static DWORD PipeTimeout = 30000; /* 30 Seconds */
 
+/* Maximum number of services being started at the same time during auto-start */
+#define SCM_MAX_START_THREADS 8
+
 
 /* FUNCTIONS *****************************************************************/
 
@@ -2015,57 +2018,25 @@ ScmStartUserModeService(PSERVICE Service,
 }
 
 
-static DWORD
-ScmLoadService(PSERVICE Service,
-               DWORD argc,
-               LPWSTR* argv)
+static VOID
+ScmReleaseServiceImage(PSERVICE Service)
 {
-    PSERVICE_GROUP Group = Service->lpGroup;
-    DWORD dwError = ERROR_SUCCESS;
-    LPCWSTR lpLogStrings[2];
-    WCHAR szLogBuffer[80];
-
-    DPRINT("ScmLoadService() called\n");
-    DPRINT("Start Service %p (%S)\n", Service, Service->lpServiceName);
-
-    if (Service->Status.dwCurrentState != SERVICE_STOPPED)
+    Service->lpImage->dwImageRunCount--;
+    if (Service->lpImage->dwImageRunCount == 0)
     {
-        DPRINT("Service %S is already running\n", Service->lpServiceName);
-        return ERROR_SERVICE_ALREADY_RUNNING;
+        ScmRemoveServiceImage(Service->lpImage);
+        Service->lpImage = NULL;
     }
+}
 
-    DPRINT("Service->Type: %lu\n", Service->Status.dwServiceType);
-
-    if (Service->Status.dwServiceType & SERVICE_DRIVER)
-    {
-        /* Start the driver */
-        dwError = ScmStartDriver(Service);
-    }
-    else // if (Service->Status.dwServiceType & (SERVICE_WIN32 | SERVICE_INTERACTIVE_PROCESS))
-    {
-        /* Start user-mode service */
-        dwError = ScmCreateOrReferenceServiceImage(Service);
-        if (dwError == ERROR_SUCCESS)
-        {
-            dwError = ScmStartUserModeService(Service, argc, argv);
-            if (dwError == ERROR_SUCCESS)
-            {
-                Service->Status.dwCurrentState = SERVICE_START_PENDING;
-                Service->Status.dwControlsAccepted = 0;
-            }
-            else
-            {
-                Service->lpImage->dwImageRunCount--;
-                if (Service->lpImage->dwImageRunCount == 0)
-                {
-                    ScmRemoveServiceImage(Service->lpImage);
-                    Service->lpImage = NULL;
-                }
-            }
-        }
-    }
 
-    DPRINT("ScmLoadService() done (Error %lu)\n", dwError);
+static VOID
+ScmReportServiceStart(PSERVICE Service,
+                      DWORD dwError)
+{
+    PSERVICE_GROUP Group = Service->lpGroup;
+    LPCWSTR lpLogStrings[2];
+    WCHAR szLogBuffer[80];
 
     if (dwError == ERROR_SUCCESS)
     {
@@ -2122,6 +2093,54 @@ ScmLoadService(PSERVICE Service,
         }
 #endif
     }
+}
+
+
+static DWORD
+ScmLoadService(PSERVICE Service,
+               DWORD argc,
+               LPWSTR* argv)
+{
+    DWORD dwError = ERROR_SUCCESS;
+
+    DPRINT("ScmLoadService() called\n");
+    DPRINT("Start Service %p (%S)\n", Service, Service->lpServiceName);
+
+    if (Service->Status.dwCurrentState != SERVICE_STOPPED)
+    {
+        DPRINT("Service %S is already running\n", Service->lpServiceName);
+        return ERROR_SERVICE_ALREADY_RUNNING;
+    }
+
+    DPRINT("Service->Type: %lu\n", Service->Status.dwServiceType);
+
+    if (Service->Status.dwServiceType & SERVICE_DRIVER)
+    {
+        /* Start the driver */
+        dwError = ScmStartDriver(Service);
+    }
+    else // if (Service->Status.dwServiceType & (SERVICE_WIN32 | SERVICE_INTERACTIVE_PROCESS))
+    {
+        /* Start user-mode service */
+        dwError = ScmCreateOrReferenceServiceImage(Service);
+        if (dwError == ERROR_SUCCESS)
+        {
+            dwError = ScmStartUserModeService(Service, argc, argv);
+            if (dwError == ERROR_SUCCESS)
+            {
+                Service->Status.dwCurrentState = SERVICE_START_PENDING;
+                Service->Status.dwControlsAccepted = 0;
+            }
+            else
+            {
+                ScmReleaseServiceImage(Service);
+            }
+        }
+    }
+
+    DPRINT("ScmLoadService() done (Error %lu)\n", dwError);
+
+    ScmReportServiceStart(Service, dwError);
 
     return dwError;
 }
@@ -2167,6 +2186,338 @@ done:
 }
 
 
+typedef struct _START_ENTRY
+{
+    PSERVICE Service;
+    PULONG DependOn;        /* Indices of the batch entries this one depends on */
+    ULONG DependOnCount;
+    HANDLE hThread;
+    BOOLEAN Started;
+    BOOLEAN Finished;
+} START_ENTRY, *PSTART_ENTRY;
+
+
+static DWORD
+WINAPI
+ScmStartServiceThread(LPVOID lpParameter)
+{
+    PSERVICE Service = (PSERVICE)lpParameter;
+    DWORD dwError;
+
+    dwError = ScmStartUserModeService(Service, 0, NULL);
+    if (dwError == ERROR_SUCCESS)
+    {
+        Service->Status.dwCurrentState = SERVICE_START_PENDING;
+        Service->Status.dwControlsAccepted = 0;
+    }
+
+    return dwError;
+}
+
+
+static VOID
+ScmGetBatchDependencies(PSTART_ENTRY Entries,
+                        ULONG Count,
+                        PSTART_ENTRY Entry)
+{
+    HKEY hServiceKey;
+    LPWSTR lpDependOnService = NULL;
+    LPWSTR lpName;
+    ULONG i, j;
+
+    if (ScmOpenServiceKey(Entry->Service->lpServiceName,
+                          KEY_READ,
+                          &hServiceKey) != ERROR_SUCCESS)
+        return;
+
+    ScmReadString(hServiceKey, L"DependOnService", &lpDependOnService);
+    RegCloseKey(hServiceKey);
+
+    if (lpDependOnService == NULL)
+        return;
+
+    /* Only the services of this batch matter, the other ones were started before */
+    for (lpName = lpDependOnService; *lpName; lpName += wcslen(lpName) + 1)
+    {
+        for (i = 0; i < Count; i++)
+        {
+            if (&Entries[i] == Entry ||
+                _wcsicmp(Entries[i].Service->lpServiceName, lpName) != 0)
+                continue;
+
+            if (Entry->DependOn == NULL)
+            {
+                Entry->DependOn = HeapAlloc(GetProcessHeap(), 0, Count * sizeof(ULONG));
+                if (Entry->DependOn == NULL)
+                    break;
+            }
+
+            /* The list may name a service more than once, the array only has room for each entry once */
+            for (j = 0; j < Entry->DependOnCount; j++)
+            {
+                if (Entry->DependOn[j] == i)
+                    break;
+            }
+
+            if (j == Entry->DependOnCount)
+                Entry->DependOn[Entry->DependOnCount++] = i;
+            break;
+        }
+    }
+
+    HeapFree(GetProcessHeap(), 0, lpDependOnService);
+}
+
+
+static BOOL
+ScmIsBatchEntryReady(PSTART_ENTRY Entries,
+                     PSTART_ENTRY Entry)
+{
+    ULONG i;
+
+    for (i = 0; i < Entry->DependOnCount; i++)
+    {
+        if (!Entries[Entry->DependOn[i]].Finished)
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+
+/*
+ * Returns FALSE if the entry has to be started inline but cannot be yet:
+ * a user-mode service started inline may share its image with a service
+ * whose worker has not connected to the control pipe yet, so it has to
+ * wait until no worker is running anymore.
+ */
+static BOOL
+ScmStartBatchEntry(PSTART_ENTRY Entry,
+                   BOOL bAllowThread,
+                   BOOL bWorkersRunning)
+{
+    PSERVICE Service = Entry->Service;
+    DWORD dwError;
+
+    /*
+     * Only a service running in a new process of its own can be started by
+     * a worker thread: its image, control pipe and process are not shared
+     * with any other service. Everything else is started right here.
+     */
+    if (!bAllowThread ||
+        Service->Status.dwCurrentState != SERVICE_STOPPED ||
+        Service->Status.dwServiceType != SERVICE_WIN32_OWN_PROCESS)
+    {
+        if (bWorkersRunning && (Service->Status.dwServiceType & SERVICE_WIN32))
+            return FALSE;
+
+        Entry->Started = TRUE;
+        ScmLoadService(Service, 0, NULL);
+        Entry->Finished = TRUE;
+        return TRUE;
+    }
+
+    dwError = ScmCreateOrReferenceServiceImage(Service);
+    if (dwError == ERROR_SUCCESS)
+    {
+        if (Service->lpImage->dwImageRunCount > 1)
+        {
+            /* The image is used by another service, don't race with it */
+            ScmReleaseServiceImage(Service);
+            if (bWorkersRunning)
+                return FALSE;
+
+            Entry->Started = TRUE;
+            ScmLoadService(Service, 0, NULL);
+            Entry->Finished = TRUE;
+            return TRUE;
+        }
+
+        Entry->Started = TRUE;
+
+        Entry->hThread = CreateThread(NULL,
+                                      0,
+                                      ScmStartServiceThread,
+                                      Service,
+                                      0,
+                                      NULL);
+        if (Entry->hThread != NULL)
+            return TRUE;
+
+        DPRINT1("CreateThread() failed (Error %lu)\n", GetLastError());
+        dwError = ScmStartServiceThread(Service);
+        if (dwError != ERROR_SUCCESS)
+            ScmReleaseServiceImage(Service);
+    }
+
+    Entry->Started = TRUE;
+    ScmReportServiceStart(Service, dwError);
+    Entry->Finished = TRUE;
+    return TRUE;
+}
+
+
+static VOID
+ScmFinishBatchEntry(PSTART_ENTRY Entry)
+{
+    DWORD dwError = ERROR_GEN_FAILURE;
+
+    GetExitCodeThread(Entry->hThread, &dwError);
+    CloseHandle(Entry->hThread);
+    Entry->hThread = NULL;
+
+    DPRINT("Service %S started by a worker thread (Error %lu)\n",
+           Entry->Service->lpServiceName, dwError);
+
+    if (dwError != ERROR_SUCCESS)
+        ScmReleaseServiceImage(Entry->Service);
+
+    ScmReportServiceStart(Entry->Service, dwError);
+    Entry->Finished = TRUE;
+}
+
+
+/*
+ * Starts a set of services whose relative start order is not imposed by
+ * their group or tag. A service is only started once the services of the
+ * set it depends on have been started, and up to SCM_MAX_START_THREADS
+ * services are waited for at the same time.
+ */
+static VOID
+ScmStartServiceBatch(PSERVICE *Services,
+                     ULONG Count)
+{
+    PSTART_ENTRY Entries;
+    HANDLE Threads[SCM_MAX_START_THREADS];
+    ULONG ThreadEntries[SCM_MAX_START_THREADS];
+    ULONG Running = 0;
+    ULONG Finished = 0;
+    ULONG i;
+    DWORD dwWait;
+    BOOL bStarted;
+
+    if (Count == 0)
+        return;
+
+    Entries = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, Count * sizeof(START_ENTRY));
+    if (Entries == NULL)
+    {
+        /* Fall back to starting the services one after the other */
+        for (i = 0; i < Count; i++)
+            ScmLoadService(Services[i], 0, NULL);
+        return;
+    }
+
+    for (i = 0; i < Count; i++)
+        Entries[i].Service = Services[i];
+
+    for (i = 0; i < Count; i++)
+        ScmGetBatchDependencies(Entries, Count, &Entries[i]);
+
+    while (Finished < Count)
+    {
+        /* Start every service whose dependencies are satisfied */
+        bStarted = FALSE;
+        for (i = 0; i < Count && Running < SCM_MAX_START_THREADS; i++)
+        {
+            if (Entries[i].Started || !ScmIsBatchEntryReady(Entries, &Entries[i]))
+                continue;
+
+            if (!ScmStartBatchEntry(&Entries[i], TRUE, Running != 0))
+                continue;
+
+            bStarted = TRUE;
+
+            if (Entries[i].hThread != NULL)
+            {
+                Threads[Running] = Entries[i].hThread;
+                ThreadEntries[Running] = i;
+                Running++;
+            }
+            else
+            {
+                Finished++;
+            }
+        }
+
+        if (Running == 0)
+        {
+            if (bStarted || Finished == Count)
+                continue;
+
+            /* Circular dependencies: start the first remaining service anyway */
+            for (i = 0; Entries[i].Started; i++)
+                ;
+
+            DPRINT1("Service %S has circular dependencies\n", Entries[i].Service->lpServiceName);
+            ScmStartBatchEntry(&Entries[i], FALSE, FALSE);
+            Finished++;
+            continue;
+        }
+
+        /* Wait for one of the workers to finish */
+        dwWait = WaitForMultipleObjects(Running, Threads, FALSE, INFINITE);
+        if (dwWait >= WAIT_OBJECT_0 + Running)
+        {
+            DPRINT1("WaitForMultipleObjects() failed (Error %lu)\n", GetLastError());
+            dwWait = WAIT_OBJECT_0;
+            WaitForSingleObject(Threads[0], INFINITE);
+        }
+
+        i = dwWait - WAIT_OBJECT_0;
+        ScmFinishBatchEntry(&Entries[ThreadEntries[i]]);
+        Finished++;
+
+        Running--;
+        Threads[i] = Threads[Running];
+        ThreadEntries[i] = ThreadEntries[Running];
+    }
+
+    for (i = 0; i < Count; i++)
+    {
+        if (Entries[i].DependOn != NULL)
+            HeapFree(GetProcessHeap(), 0, Entries[i].DependOn);
+    }
+
+    HeapFree(GetProcessHeap(), 0, Entries);
+}
+
+
+static ULONG
+ScmCollectAutoStartServices(PSERVICE_GROUP Group,
+                            BOOL bAnyGroup,
+                            PSERVICE *Services)
+{
+    PLIST_ENTRY ServiceEntry;
+    PSERVICE CurrentService;
+    ULONG Count = 0;
+
+    ServiceEntry = ServiceListHead.Flink;
+    while (ServiceEntry != &ServiceListHead)
+    {
+        CurrentService = CONTAINING_RECORD(ServiceEntry, SERVICE, ServiceListEntry);
+
+        if ((bAnyGroup ? (CurrentService->lpGroup != NULL)
+                       : (CurrentService->lpGroup == Group)) &&
+            (CurrentService->dwStartType == SERVICE_AUTO_START) &&
+            (CurrentService->ServiceVisited == FALSE))
+        {
+            CurrentService->ServiceVisited = TRUE;
+
+            /* Without a buffer, start the services one after the other */
+            if (Services != NULL)
+                Services[Count++] = CurrentService;
+            else
+                ScmLoadService(CurrentService, 0, NULL);
+        }
+
+        ServiceEntry = ServiceEntry->Flink;
+    }
+
+    return Count;
+}
+
+
 VOID
 ScmAutoStartServices(VOID)
 {
@@ -2175,6 +2526,8 @@ ScmAutoStartServices(VOID)
     PLIST_ENTRY ServiceEntry;
     PSERVICE_GROUP CurrentGroup;
     PSERVICE CurrentService;
+    PSERVICE *Services;
+    ULONG ServiceCount = 0;
     WCHAR szSafeBootServicePath[MAX_PATH];
     DWORD SafeBootEnabled;
     HKEY hKey;
@@ -2278,9 +2631,13 @@ ScmAutoStartServices(VOID)
             }
         }
 
+        ServiceCount++;
         ServiceEntry = ServiceEntry->Flink;
     }
 
+    /* Buffer for the services which can be started concurrently */
+    Services = HeapAlloc(GetProcessHeap(), 0, ServiceCount * sizeof(PSERVICE));
+
     /* Start all services which are members of an existing group */
     GroupEntry = GroupListHead.Flink;
     while (GroupEntry != &GroupListHead)
@@ -2311,58 +2668,22 @@ ScmAutoStartServices(VOID)
         }
 
         /* Start all services which have an invalid tag or which do not have a tag */
-        ServiceEntry = ServiceListHead.Flink;
-        while (ServiceEntry != &ServiceListHead)
-        {
-            CurrentService = CONTAINING_RECORD(ServiceEntry, SERVICE, ServiceListEntry);
-
-            if ((CurrentService->lpGroup == CurrentGroup) &&
-                (CurrentService->dwStartType == SERVICE_AUTO_START) &&
-                (CurrentService->ServiceVisited == FALSE))
-            {
-                CurrentService->ServiceVisited = TRUE;
-                ScmLoadService(CurrentService, 0, NULL);
-            }
-
-            ServiceEntry = ServiceEntry->Flink;
-        }
+        ScmStartServiceBatch(Services,
+                             ScmCollectAutoStartServices(CurrentGroup, FALSE, Services));
 
         GroupEntry = GroupEntry->Flink;
     }
 
     /* Start all services which are members of any non-existing group */
-    ServiceEntry = ServiceListHead.Flink;
-    while (ServiceEntry != &ServiceListHead)
-    {
-        CurrentService = CONTAINING_RECORD(ServiceEntry, SERVICE, ServiceListEntry);
-
-        if ((CurrentService->lpGroup != NULL) &&
-            (CurrentService->dwStartType == SERVICE_AUTO_START) &&
-            (CurrentService->ServiceVisited == FALSE))
-        {
-            CurrentService->ServiceVisited = TRUE;
-            ScmLoadService(CurrentService, 0, NULL);
-        }
-
-        ServiceEntry = ServiceEntry->Flink;
-    }
+    ScmStartServiceBatch(Services,
+                         ScmCollectAutoStartServices(NULL, TRUE, Services));
 
     /* Start all services which are not a member of any group */
-    ServiceEntry = ServiceListHead.Flink;
-    while (ServiceEntry != &ServiceListHead)
-    {
-        CurrentService = CONTAINING_RECORD(ServiceEntry, SERVICE, ServiceListEntry);
+    ScmStartServiceBatch(Services,
+                         ScmCollectAutoStartServices(NULL, FALSE, Services));
 
-        if ((CurrentService->lpGroup == NULL) &&
-            (CurrentService->dwStartType == SERVICE_AUTO_START) &&
-            (CurrentService->ServiceVisited == FALSE))
-        {
-            CurrentService->ServiceVisited = TRUE;
-            ScmLoadService(CurrentService, 0, NULL);
-        }
-
-        ServiceEntry = ServiceEntry->Flink;
-    }
+    if (Services != NULL)
+        HeapFree(GetProcessHeap(), 0, Services);
 
     /* Clear 'ServiceVisited' flag again */
     ServiceEntry = ServiceListHead.Flink;
@@ -351,6 +351,7 @@ DnsQuery_CodePage(UINT CodePage,
         }
 
         ConvertedRecord->wType = QueryResultWide->wType;
+        ConvertedRecord->dwTtl = QueryResultWide->dwTtl;
 
         switch (QueryResultWide->wType)
         {
@@ -660,6 +661,7 @@ Query_Main(LPCWSTR Name,
     int quflags = (Options & DNS_QUERY_NO_RECURSION) == 0 ? adns_qf_search : 0;
     int adns_error;
     adns_answer *answer;
+    struct timeval now;
     LPSTR CurrentName;
     unsigned CNameLoop;
     PFIXED_INFO network_info;
@@ -751,6 +753,9 @@ Query_Main(LPCWSTR Name,
             (*QueryResultSet)->Flags.S.CharSet = DnsCharSetUnicode;
             (*QueryResultSet)->Data.A.IpAddress = Address;
 
+            /* The address of this machine may change at any time, don't let it be cached */
+            (*QueryResultSet)->dwTtl = 0;
+
             (*QueryResultSet)->pName = (LPSTR)DnsCToW(HostWithDomainName);
 
             RtlFreeHeap(RtlGetProcessHeap(), 0, HostWithDomainName);
@@ -844,6 +849,11 @@ Query_Main(LPCWSTR Name,
                 (*QueryResultSet)->Flags.S.CharSet = DnsCharSetUnicode;
                 (*QueryResultSet)->Data.A.IpAddress = answer->rrs.addr->addr.inet.sin_addr.s_addr;
 
+                /* adns gives the absolute expiry time of the answer */
+                (*QueryResultSet)->dwTtl = 0;
+                if (adns_gettimeofday(&now, NULL) == 0 && answer->expires > now.tv_sec)
+                    (*QueryResultSet)->dwTtl = (DWORD)(answer->expires - now.tv_sec);
+
                 adns_finish(astate);
 
                 (*QueryResultSet)->pName = (LPSTR)xstrsave(Name);
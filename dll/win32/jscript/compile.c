@@ -2500,3 +2500,51 @@ HRESULT compile_script(script_ctx_t *ctx, const WCHAR *code, const WCHAR *args,
     *ret = compiler.code;
     return S_OK;
 }
+
+#ifdef __REACTOS__
+/* eval() is often called with the same code again and again, so the last
+ * few compiled sources are kept in the script context. */
+HRESULT compile_eval_code(script_ctx_t *ctx, const WCHAR *code, bytecode_t **ret)
+{
+    bytecode_t *bytecode;
+    unsigned i;
+    HRESULT hres;
+
+    /* with conditional compilation, the result depends on the cc variables */
+    if(!ctx->cc) {
+        for(i=0; i < EVAL_CACHE_SIZE && ctx->eval_cache[i]; i++) {
+            bytecode = ctx->eval_cache[i];
+            if(!wcscmp(bytecode->source, code)) {
+                memmove(ctx->eval_cache+1, ctx->eval_cache, i*sizeof(*ctx->eval_cache));
+                ctx->eval_cache[0] = bytecode;
+                *ret = bytecode_addref(bytecode);
+                return S_OK;
+            }
+        }
+    }
+
+    hres = compile_script(ctx, code, NULL, NULL, TRUE, FALSE, &bytecode);
+    if(FAILED(hres))
+        return hres;
+
+    if(!ctx->cc) {
+        if(ctx->eval_cache[EVAL_CACHE_SIZE-1])
+            release_bytecode(ctx->eval_cache[EVAL_CACHE_SIZE-1]);
+        memmove(ctx->eval_cache+1, ctx->eval_cache, (EVAL_CACHE_SIZE-1)*sizeof(*ctx->eval_cache));
+        ctx->eval_cache[0] = bytecode_addref(bytecode);
+    }
+
+    *ret = bytecode;
+    return S_OK;
+}
+
+void release_eval_cache(script_ctx_t *ctx)
+{
+    unsigned i;
+
+    for(i=0; i < EVAL_CACHE_SIZE && ctx->eval_cache[i]; i++) {
+        release_bytecode(ctx->eval_cache[i]);
+        ctx->eval_cache[i] = NULL;
+    }
+}
+#endif
@@ -601,6 +601,43 @@ static HRESULT detach_variable_object(script_ctx_t *ctx, call_frame_t *frame, BO
     return S_OK;
 }
 
+#ifdef __REACTOS__
+/* Looking up names in the host objects (e.g. the HTML window) may be expensive,
+ * and global members are looked up each time an identifier isn't found in
+ * the script itself, so the DISPIDs that were found are remembered. */
+static HRESULT get_global_member_id(script_ctx_t *ctx, named_item_t *item, BSTR identifier, DISPID *id)
+{
+    named_item_id_t *entry = NULL;
+    const WCHAR *ptr;
+    unsigned hash = 0;
+    WCHAR *name;
+    HRESULT hres;
+
+    if(!item->id_cache)
+        item->id_cache = heap_alloc_zero(NAMED_ITEM_ID_CACHE_SIZE*sizeof(*item->id_cache));
+
+    if(item->id_cache) {
+        for(ptr = identifier; *ptr; ptr++)
+            hash = hash*31 + *ptr;
+
+        entry = item->id_cache + hash % NAMED_ITEM_ID_CACHE_SIZE;
+        if(entry->name && !wcscmp(entry->name, identifier)) {
+            *id = entry->id;
+            return S_OK;
+        }
+    }
+
+    hres = disp_get_id(ctx, item->disp, identifier, identifier, 0, id);
+    if(SUCCEEDED(hres) && entry && (name = heap_strdupW(identifier))) {
+        heap_free(entry->name);
+        entry->name = name;
+        entry->id = *id;
+    }
+
+    return hres;
+}
+#endif
+
 static BOOL lookup_global_members(script_ctx_t *ctx, BSTR identifier, exprval_t *ret)
 {
     named_item_t *item;
@@ -609,7 +646,11 @@ static BOOL lookup_global_members(script_ctx_t *ctx, BSTR identifier, exprval_t
 
     for(item = ctx->named_items; item; item = item->next) {
         if(item->flags & SCRIPTITEM_GLOBALMEMBERS) {
+#ifdef __REACTOS__
+            hres = get_global_member_id(ctx, item, identifier, &id);
+#else
             hres = disp_get_id(ctx, item->disp, identifier, identifier, 0, &id);
+#endif
             if(SUCCEEDED(hres)) {
                 if(ret)
                     exprval_set_disp_ref(ret, item->disp, id);
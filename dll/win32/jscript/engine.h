@@ -191,6 +191,10 @@ typedef struct _bytecode_t {
 } bytecode_t;
 
 HRESULT compile_script(script_ctx_t*,const WCHAR*,const WCHAR*,const WCHAR*,BOOL,BOOL,bytecode_t**) DECLSPEC_HIDDEN;
+#ifdef __REACTOS__
+HRESULT compile_eval_code(script_ctx_t*,const WCHAR*,bytecode_t**) DECLSPEC_HIDDEN;
+void release_eval_cache(script_ctx_t*) DECLSPEC_HIDDEN;
+#endif
 void release_bytecode(bytecode_t*) DECLSPEC_HIDDEN;
 
 static inline bytecode_t *bytecode_addref(bytecode_t *code)
@@ -208,7 +208,11 @@ HRESULT JSGlobal_eval(script_ctx_t *ctx, vdisp_t *jsthis, WORD flags, unsigned a
         return E_OUTOFMEMORY;
 
     TRACE("parsing %s\n", debugstr_jsval(argv[0]));
+#ifdef __REACTOS__
+    hres = compile_eval_code(ctx, src, &code);
+#else
     hres = compile_script(ctx, src, NULL, NULL, TRUE, FALSE, &code);
+#endif
     if(FAILED(hres)) {
         WARN("parse (%s) failed: %08x\n", debugstr_jsval(argv[0]), hres);
         return throw_syntax_error(ctx, hres, NULL);
@@ -71,6 +71,9 @@ void script_release(script_ctx_t *ctx)
 
     jsval_release(ctx->acc);
     clear_ei(ctx);
+#ifdef __REACTOS__
+    release_eval_cache(ctx);
+#endif
     if(ctx->cc)
         release_cc(ctx->cc);
     heap_pool_free(&ctx->tmp_heap);
@@ -193,6 +196,15 @@ static void decrease_state(JScript *This, SCRIPTSTATE state)
 
                     if(iter->disp)
                         IDispatch_Release(iter->disp);
+#ifdef __REACTOS__
+                    if(iter->id_cache) {
+                        unsigned i;
+
+                        for(i=0; i < NAMED_ITEM_ID_CACHE_SIZE; i++)
+                            heap_free(iter->id_cache[i].name);
+                        heap_free(iter->id_cache);
+                    }
+#endif
                     heap_free(iter->name);
                     heap_free(iter);
                     iter = iter2;
@@ -571,6 +583,9 @@ static HRESULT WINAPI JScript_AddNamedItem(IActiveScript *iface,
 
     item->disp = disp;
     item->flags = dwFlags;
+#ifdef __REACTOS__
+    item->id_cache = NULL;
+#endif
     item->name = heap_strdupW(pstrName);
     if(!item->name) {
         if(disp)
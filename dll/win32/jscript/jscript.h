@@ -359,14 +359,33 @@ HRESULT decode_source(WCHAR*) DECLSPEC_HIDDEN;
 HRESULT double_to_string(double,jsstr_t**) DECLSPEC_HIDDEN;
 BOOL is_finite(double) DECLSPEC_HIDDEN;
 
+#ifdef __REACTOS__
+#define NAMED_ITEM_ID_CACHE_SIZE 64
+
+typedef struct {
+    WCHAR *name;
+    DISPID id;
+} named_item_id_t;
+#endif
+
 typedef struct named_item_t {
     IDispatch *disp;
     DWORD flags;
     LPWSTR name;
 
+#ifdef __REACTOS__
+    /* DISPIDs of the global members found in disp */
+    named_item_id_t *id_cache;
+#endif
+
     struct named_item_t *next;
 } named_item_t;
 
+#ifdef __REACTOS__
+/* Number of compiled eval() sources to keep in a script_ctx_t */
+#define EVAL_CACHE_SIZE 8
+#endif
+
 typedef struct _cc_var_t cc_var_t;
 
 typedef struct {
@@ -421,6 +440,9 @@ struct _script_ctx_t {
     BOOL html_mode;
     LCID lcid;
     cc_ctx_t *cc;
+#ifdef __REACTOS__
+    struct _bytecode_t *eval_cache[EVAL_CACHE_SIZE];
+#endif
     JSCaller *jscaller;
     jsexcept_t ei;
 
@@ -347,6 +347,22 @@ typedef struct tagMSIVIEWOPS
      * drop - drops the table from the database
      */
     UINT (*drop)( struct tagMSIVIEW *view );
+
+#ifdef __REACTOS__
+    /*
+     * find_matching_rows - iterates through rows that match a value
+     *
+     * If the column type is a string then a string ID should be passed in.
+     *  If the value to be looked up is an integer then no transformation of
+     *  the input value is required, it is compared with the value returned
+     *  by fetch_int.
+     * The handle is an input/output parameter that keeps track of the current
+     *  position in the iteration. It must be initialised to zero before the
+     *  first call and continued to be passed in to subsequent calls.
+     * The rows are returned in ascending order.
+     */
+    UINT (*find_matching_rows)( struct tagMSIVIEW *view, UINT col, UINT val, UINT *row, MSIITERHANDLE *handle );
+#endif
 } MSIVIEWOPS;
 
 struct tagMSIVIEW
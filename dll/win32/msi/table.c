@@ -55,6 +55,9 @@ typedef struct tagMSICOLUMNINFO
     UINT    type;
     UINT    offset;
     MSICOLUMNHASHENTRY **hash_table;
+#ifdef __REACTOS__
+    UINT    hash_size;
+#endif
 } MSICOLUMNINFO;
 
 struct tagMSITABLE
@@ -359,6 +362,19 @@ static void msi_free_colinfo( MSICOLUMNINFO *colinfo, UINT count )
     for (i = 0; i < count; i++) msi_free( colinfo[i].hash_table );
 }
 
+#ifdef __REACTOS__
+/* drops the row indexes of all the columns, e.g. when rows are added or moved */
+static void free_hash_tables( MSITABLE *table )
+{
+    UINT i;
+    for (i = 0; i < table->col_count; i++)
+    {
+        msi_free( table->colinfo[i].hash_table );
+        table->colinfo[i].hash_table = NULL;
+    }
+}
+#endif
+
 static void free_table( MSITABLE *table )
 {
     UINT i;
@@ -1174,8 +1190,16 @@ static UINT table_set_bytes( MSITABLEVIEW *tv, UINT row, UINT col, UINT val )
         return ERROR_FUNCTION_FAILED;
     }
 
+#ifdef __REACTOS__
+    if (col <= tv->table->col_count)
+    {
+        msi_free( tv->table->colinfo[col-1].hash_table );
+        tv->table->colinfo[col-1].hash_table = NULL;
+    }
+#else
     msi_free( tv->columns[col-1].hash_table );
     tv->columns[col-1].hash_table = NULL;
+#endif
 
     n = bytes_per_column( tv->db, &tv->columns[col - 1], LONG_STR_BYTES );
     if ( n != 2 && n != 3 && n != 4 )
@@ -1489,6 +1513,11 @@ static UINT table_create_new_row( struct tagMSIVIEW *view, UINT *num, BOOL tempo
     if( !row )
         return ERROR_NOT_ENOUGH_MEMORY;
 
+#ifdef __REACTOS__
+    /* the rows following the new one are going to move */
+    free_hash_tables( tv->table );
+#endif
+
     row_count = &tv->table->row_count;
     data_ptr = &tv->table->data;
     data_persist_ptr = &tv->table->data_persistent;
@@ -1757,11 +1786,15 @@ static UINT TABLE_delete_row( struct tagMSIVIEW *view, UINT row )
     tv->table->row_count--;
 
     /* reset the hash tables */
+#ifdef __REACTOS__
+    free_hash_tables( tv->table );
+#else
     for (i = 0; i < tv->num_cols; i++)
     {
         msi_free( tv->columns[i].hash_table );
         tv->columns[i].hash_table = NULL;
     }
+#endif
 
     for (i = row + 1; i < num_rows; i++)
     {
@@ -1945,6 +1978,9 @@ static UINT TABLE_remove_column(struct tagMSIVIEW *view, UINT number)
     if (tv->table->colinfo[number-1].type & MSITYPE_TEMPORARY)
     {
         UINT size = tv->table->colinfo[number-1].offset;
+#ifdef __REACTOS__
+        msi_free( tv->table->colinfo[number-1].hash_table );
+#endif
         tv->table->col_count--;
         tv->table->colinfo = msi_realloc( tv->table->colinfo, sizeof(*tv->table->colinfo) * tv->table->col_count );
 
@@ -2163,6 +2199,102 @@ done:
     return r;
 }
 
+#ifdef __REACTOS__
+static UINT TABLE_find_matching_rows( struct tagMSIVIEW *view, UINT col,
+    UINT val, UINT *row, MSIITERHANDLE *handle )
+{
+    MSITABLEVIEW *tv = (MSITABLEVIEW*)view;
+    const MSICOLUMNHASHENTRY *entry;
+
+    TRACE("%p, %d, %u, %p\n", view, col, val, *handle);
+
+    if( !tv->table )
+        return ERROR_INVALID_PARAMETER;
+
+    if( (col==0) || (col > tv->num_cols) )
+        return ERROR_INVALID_PARAMETER;
+
+    /* the hash tables belong to the table, not to a copy of its columns */
+    if( tv->columns != tv->table->colinfo )
+        return ERROR_FUNCTION_FAILED;
+
+    if( !tv->columns[col-1].hash_table )
+    {
+        UINT i, hash_size;
+        UINT num_rows = tv->table->row_count;
+        MSICOLUMNHASHENTRY **hash_table;
+        MSICOLUMNHASHENTRY *new_entry;
+        MSICOLUMNHASHENTRY **last;
+
+        if( tv->columns[col-1].offset >= tv->row_size )
+        {
+            ERR("Stuffed up %d >= %d\n", tv->columns[col-1].offset, tv->row_size );
+            ERR("%p %p\n", tv, tv->columns );
+            return ERROR_FUNCTION_FAILED;
+        }
+
+        /* about one bucket per row keeps the buckets short without
+         * wasting memory on small tables */
+        hash_size = max( num_rows, MSITABLE_HASH_TABLE_SIZE ) | 1;
+
+        /* allocate contiguous memory for the table and its entries so we
+         * don't have to do an expensive cleanup */
+        hash_table = msi_alloc_zero(hash_size * sizeof(MSICOLUMNHASHENTRY*) +
+            num_rows * sizeof(MSICOLUMNHASHENTRY));
+        if (!hash_table)
+            return ERROR_OUTOFMEMORY;
+
+        /* keep track of the tail of each bucket, so that the rows stay in order */
+        last = msi_alloc_zero(hash_size * sizeof(MSICOLUMNHASHENTRY*));
+        if (!last)
+        {
+            msi_free(hash_table);
+            return ERROR_OUTOFMEMORY;
+        }
+        new_entry = (MSICOLUMNHASHENTRY *)(hash_table + hash_size);
+
+        for (i = 0; i < num_rows; i++)
+        {
+            UINT row_value, bucket;
+
+            if (view->ops->fetch_int( view, i, col, &row_value ) != ERROR_SUCCESS)
+                continue;
+
+            new_entry->next = NULL;
+            new_entry->value = row_value;
+            new_entry->row = i;
+
+            bucket = row_value % hash_size;
+            if (last[bucket])
+                last[bucket]->next = new_entry;
+            else
+                hash_table[bucket] = new_entry;
+            last[bucket] = new_entry++;
+        }
+
+        msi_free(last);
+        tv->columns[col-1].hash_table = hash_table;
+        tv->columns[col-1].hash_size = hash_size;
+    }
+
+    if( !*handle )
+        entry = tv->columns[col-1].hash_table[val % tv->columns[col-1].hash_size];
+    else
+        entry = (*handle)->next;
+
+    while (entry && entry->value != val)
+        entry = entry->next;
+
+    *handle = entry;
+    if (!entry)
+        return ERROR_NO_MORE_ITEMS;
+
+    *row = entry->row;
+
+    return ERROR_SUCCESS;
+}
+#endif
+
 static const MSIVIEWOPS table_ops =
 {
     TABLE_fetch_int,
@@ -2184,6 +2316,9 @@ static const MSIVIEWOPS table_ops =
     TABLE_add_column,
     NULL,
     TABLE_drop,
+#ifdef __REACTOS__
+    TABLE_find_matching_rows,
+#endif
 };
 
 UINT TABLE_CreateView( MSIDATABASE *db, LPCWSTR name, MSIVIEW **view )
@@ -51,6 +51,12 @@ typedef struct tagJOINTABLE
     UINT col_count;
     UINT row_count;
     UINT table_index;
+#ifdef __REACTOS__
+    /* comparison with this table's column that allows to look up the candidate rows */
+    const struct expr *lookup_column;
+    const struct expr *lookup_value;
+    UINT lookup_rec_index;
+#endif
 } JOINTABLE;
 
 typedef struct tagMSIORDERINFO
@@ -647,6 +653,199 @@ static UINT WHERE_evaluate( MSIWHEREVIEW *wv, const UINT rows[],
     return ERROR_SUCCESS;
 }
 
+#ifdef __REACTOS__
+static UINT count_wildcards( const struct expr *expr )
+{
+    switch (expr->type)
+    {
+    case EXPR_WILDCARD:
+        return 1;
+    case EXPR_STRCMP:
+    case EXPR_COMPLEX:
+        return count_wildcards( expr->u.expr.left ) + count_wildcards( expr->u.expr.right );
+    case EXPR_UNARY:
+        return count_wildcards( expr->u.expr.left );
+    default:
+        return 0;
+    }
+}
+
+static void set_lookup( const struct expr *column, const struct expr *value, UINT rec_index )
+{
+    JOINTABLE *table = column->u.column.parsed.table;
+
+    /* comparisons with constants are better than joins */
+    if (table->lookup_column && table->lookup_value->type != column->type)
+        return;
+
+    table->lookup_column = column;
+    table->lookup_value = value;
+    table->lookup_rec_index = rec_index;
+}
+
+static BOOL is_lookup_value( const struct expr *column, const struct expr *value )
+{
+    if (value->type == EXPR_WILDCARD)
+        return TRUE;
+    if (value->type == column->type)
+        return value->u.column.parsed.table != column->u.column.parsed.table;
+    if (column->type == EXPR_COL_NUMBER_STRING)
+        return value->type == EXPR_SVAL;
+    return value->type == EXPR_UVAL;
+}
+
+/* finds the equality tests that all the rows of the result must pass */
+static void find_lookups( const struct expr *cond, UINT *rec_index )
+{
+    const struct expr *left, *right;
+
+    if ((cond->type == EXPR_COMPLEX || cond->type == EXPR_STRCMP) && cond->u.expr.op == OP_AND)
+    {
+        find_lookups( cond->u.expr.left, rec_index );
+        find_lookups( cond->u.expr.right, rec_index );
+        return;
+    }
+
+    if ((cond->type == EXPR_COMPLEX || cond->type == EXPR_STRCMP) && cond->u.expr.op == OP_EQ)
+    {
+        left = cond->u.expr.left;
+        right = cond->u.expr.right;
+
+        /* a column can only be compared with one wildcard, the next one */
+        if ((cond->type == EXPR_STRCMP && left->type == EXPR_COL_NUMBER_STRING) ||
+            (cond->type == EXPR_COMPLEX && (left->type == EXPR_COL_NUMBER || left->type == EXPR_COL_NUMBER32)))
+        {
+            if (is_lookup_value( left, right ))
+                set_lookup( left, right, *rec_index + 1 );
+        }
+        if ((cond->type == EXPR_STRCMP && right->type == EXPR_COL_NUMBER_STRING) ||
+            (cond->type == EXPR_COMPLEX && (right->type == EXPR_COL_NUMBER || right->type == EXPR_COL_NUMBER32)))
+        {
+            if (is_lookup_value( right, left ))
+                set_lookup( right, left, *rec_index + 1 );
+        }
+    }
+
+    *rec_index += count_wildcards( cond );
+}
+
+/* works out the value the table's lookup column must have for a row to match */
+static UINT get_lookup_value( MSIWHEREVIEW *wv, const JOINTABLE *table, MSIRECORD *record,
+                              const UINT rows[], UINT *val )
+{
+    const struct expr *column = table->lookup_column, *value = table->lookup_value;
+    const WCHAR *str;
+    UINT r;
+
+    if (!column || !table->view->ops->find_matching_rows)
+        return ERROR_FUNCTION_FAILED;
+
+    if (value->type == column->type)
+    {
+        r = expr_fetch_value( &value->u.column, rows, val );
+        if (r != ERROR_SUCCESS)
+            return ERROR_FUNCTION_FAILED;
+
+        /* null strings match empty ones, leave that to the comparison */
+        if (column->type == EXPR_COL_NUMBER_STRING && !*val)
+            return ERROR_FUNCTION_FAILED;
+        return ERROR_SUCCESS;
+    }
+
+    if (column->type == EXPR_COL_NUMBER_STRING)
+    {
+        if (value->type == EXPR_WILDCARD)
+        {
+            if (!record)
+                return ERROR_FUNCTION_FAILED;
+            str = MSI_RecordGetString( record, table->lookup_rec_index );
+        }
+        else
+            str = value->u.sval;
+
+        if (!str || !*str)
+            return ERROR_FUNCTION_FAILED;
+
+        /* strings that aren't in the string table can't be in a column */
+        if (msi_string2id( wv->db->strings, str, -1, val ) != ERROR_SUCCESS)
+            return ERROR_NO_MORE_ITEMS;
+        return ERROR_SUCCESS;
+    }
+
+    if (value->type == EXPR_WILDCARD)
+    {
+        if (!record)
+            return ERROR_FUNCTION_FAILED;
+        *val = MSI_RecordGetInteger( record, table->lookup_rec_index );
+    }
+    else
+        *val = value->u.uval;
+
+    /* convert to the value stored in the column, see WHERE_evaluate */
+    *val += (column->type == EXPR_COL_NUMBER) ? 0x8000 : 0x80000000;
+    return ERROR_SUCCESS;
+}
+
+static UINT check_condition( MSIWHEREVIEW *wv, MSIRECORD *record, JOINTABLE **tables,
+                             UINT table_rows[] )
+{
+    JOINTABLE *table = *tables;
+    MSIITERHANDLE handle = NULL;
+    UINT r, row = 0, value;
+    BOOL lookup = FALSE;
+    INT val;
+
+    /* only visit the rows that can match if the column can be looked up */
+    r = get_lookup_value( wv, table, record, table_rows, &value );
+    if (r == ERROR_NO_MORE_ITEMS)
+        return ERROR_SUCCESS;
+    if (r == ERROR_SUCCESS)
+    {
+        r = table->view->ops->find_matching_rows( table->view, table->lookup_column->u.column.parsed.column,
+                                                  value, &row, &handle );
+        if (r == ERROR_NO_MORE_ITEMS)
+            return ERROR_SUCCESS;
+        lookup = (r == ERROR_SUCCESS);
+        if (!lookup)
+            row = 0;
+    }
+
+    r = ERROR_SUCCESS;
+    while (row < table->row_count)
+    {
+        table_rows[table->table_index] = row;
+
+        val = 0;
+        wv->rec_index = 0;
+        r = WHERE_evaluate( wv, table_rows, wv->cond, &val, record );
+        if (r != ERROR_SUCCESS && r != ERROR_CONTINUE)
+            break;
+        if (val)
+        {
+            if (*(tables + 1))
+            {
+                r = check_condition(wv, record, tables + 1, table_rows);
+                if (r != ERROR_SUCCESS)
+                    break;
+            }
+            else
+            {
+                if (r != ERROR_SUCCESS)
+                    break;
+                add_row (wv, table_rows);
+            }
+        }
+
+        if (!lookup)
+            row++;
+        else if (table->view->ops->find_matching_rows( table->view, table->lookup_column->u.column.parsed.column,
+                                                       value, &row, &handle ) != ERROR_SUCCESS)
+            break;
+    }
+    table_rows[table->table_index] = INVALID_ROW_INDEX;
+    return r;
+}
+#else
 static UINT check_condition( MSIWHEREVIEW *wv, MSIRECORD *record, JOINTABLE **tables,
                              UINT table_rows[] )
 {
@@ -681,6 +880,7 @@ static UINT check_condition( MSIWHEREVIEW *wv, MSIRECORD *record, JOINTABLE **ta
     table_rows[(*tables)->table_index] = INVALID_ROW_INDEX;
     return r;
 }
+#endif
 
 static int __cdecl compare_entry( const void *left, const void *right )
 {
@@ -848,6 +1048,16 @@ static UINT WHERE_execute( struct tagMSIVIEW *view, MSIRECORD *record )
 
     ordered_tables = ordertables( wv );
 
+#ifdef __REACTOS__
+    for (table = wv->tables; table; table = table->next)
+        table->lookup_column = NULL;
+    if (wv->cond)
+    {
+        i = 0;
+        find_lookups( wv->cond, &i );
+    }
+#endif
+
     rows = msi_alloc( wv->table_count * sizeof(*rows) );
     for (i = 0; i < wv->table_count; i++)
         rows[i] = INVALID_ROW_INDEX;
@@ -440,6 +440,9 @@ BOOL WINAPI DllMain(HINSTANCE hInstDLL, DWORD fdwReason, LPVOID reserved)
         xmlCleanupInputCallbacks();
         xmlRegisterDefaultInputCallbacks();
 
+#ifdef __REACTOS__
+        release_xpath_cache();
+#endif
         xmlCleanupParser();
         schemasCleanup();
 #endif
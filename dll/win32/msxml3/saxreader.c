@@ -322,6 +322,12 @@ typedef struct
         BSTR szValue;
         BSTR szQName;
     } *attributes;
+
+#ifdef __REACTOS__
+    /* buffer for the characters passed to ISAXContentHandler */
+    WCHAR *chars;
+    int chars_size;
+#endif
 } saxlocator;
 
 static inline saxreader *impl_from_IVBSAXXMLReader( IVBSAXXMLReader *iface )
@@ -670,6 +676,40 @@ static BSTR pooled_bstr_from_xmlCharN(struct bstrpool *pool, const xmlChar *buf,
     return pool_entry;
 }
 
+#ifdef __REACTOS__
+/* Unlike IVBSAXContentHandler, ISAXContentHandler gets the characters in a
+ * buffer that only has to be valid during the call, so it can be reused */
+static HRESULT saxlocator_characters(saxlocator *locator, const xmlChar *buf, int len)
+{
+    struct saxcontenthandler_iface *content = saxreader_get_contenthandler(locator->saxreader);
+    static const WCHAR emptyW[] = {0};
+    int wlen;
+
+    if (!saxreader_has_handler(locator, SAXContentHandler)) return S_OK;
+
+    if (locator->vbInterface)
+        return saxreader_saxcharacters(locator, pooled_bstr_from_xmlCharN(&locator->saxreader->pool, buf, len));
+
+    wlen = len ? MultiByteToWideChar(CP_UTF8, 0, (LPCSTR)buf, len, NULL, 0) : 0;
+    if (!wlen)
+        return ISAXContentHandler_characters(content->handler, emptyW, 0);
+
+    if (wlen > locator->chars_size)
+    {
+        WCHAR *chars = heap_realloc(locator->chars, wlen * sizeof(WCHAR));
+
+        if (!chars)
+            return E_OUTOFMEMORY;
+
+        locator->chars = chars;
+        locator->chars_size = wlen;
+    }
+
+    MultiByteToWideChar(CP_UTF8, 0, (LPCSTR)buf, len, locator->chars, wlen);
+    return ISAXContentHandler_characters(content->handler, locator->chars, wlen);
+}
+#endif
+
 static void format_error_message_from_id(saxlocator *This, HRESULT hr)
 {
     struct saxerrorhandler_iface *handler = saxreader_get_errorhandler(This->saxreader);
@@ -1783,7 +1823,9 @@ static void libxmlCharacters(
         int len)
 {
     saxlocator *This = ctx;
+#ifndef __REACTOS__
     BSTR Chars;
+#endif
     HRESULT hr;
     xmlChar *cur, *end;
     BOOL lastEvent = FALSE;
@@ -1840,8 +1882,12 @@ static void libxmlCharacters(
                 This->column = 0;
         }
 
+#ifdef __REACTOS__
+        hr = saxlocator_characters(This, cur, end-cur);
+#else
         Chars = pooled_bstr_from_xmlCharN(&This->saxreader->pool, cur, end-cur);
         hr = saxreader_saxcharacters(This, Chars);
+#endif
 
         if (sax_callback_failed(This, hr))
         {
@@ -2352,6 +2398,9 @@ static ULONG WINAPI isaxlocator_Release(
             SysFreeString(This->attributes[index].szQName);
         }
         heap_free(This->attributes);
+#ifdef __REACTOS__
+        heap_free(This->chars);
+#endif
 
         /* element stack */
         LIST_FOR_EACH_ENTRY_SAFE(element, element2, &This->elements, element_entry, entry)
@@ -2481,6 +2530,11 @@ static HRESULT SAXLocator_create(saxreader *reader, saxlocator **ppsaxlocator, B
         return E_OUTOFMEMORY;
     }
 
+#ifdef __REACTOS__
+    locator->chars = NULL;
+    locator->chars_size = 0;
+#endif
+
     locator->attr_alloc_count = 8;
     locator->attr_count = 0;
     locator->attributes = heap_alloc_zero(sizeof(struct _attributes)*locator->attr_alloc_count);
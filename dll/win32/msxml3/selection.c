@@ -59,6 +59,137 @@ WINE_DEFAULT_DEBUG_CHANNEL(msxml);
 int registerNamespaces(xmlXPathContextPtr ctxt);
 xmlChar* XSLPattern_to_XPath(xmlXPathContextPtr ctxt, xmlChar const* xslpat_str);
 
+#ifdef __REACTOS__
+/* Compiled queries are kept around, as the same ones tend to be run again
+ * and again (e.g. on each node of a document). */
+#define XPATH_CACHE_SIZE 32
+
+struct xpath_cache_entry
+{
+    struct list entry;
+    LONG ref;
+    BOOL xpath;
+    xmlChar *query;
+    xmlXPathCompExprPtr comp;
+};
+
+static struct list xpath_cache = LIST_INIT(xpath_cache);
+static unsigned int xpath_cache_count;
+
+static CRITICAL_SECTION cs_xpath_cache;
+static CRITICAL_SECTION_DEBUG cs_xpath_cache_dbg =
+{
+    0, 0, &cs_xpath_cache,
+    { &cs_xpath_cache_dbg.ProcessLocksList, &cs_xpath_cache_dbg.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": xpath_cache") }
+};
+static CRITICAL_SECTION cs_xpath_cache = { &cs_xpath_cache_dbg, -1, 0, 0, 0, 0 };
+
+static void free_xpath_cache_entry(struct xpath_cache_entry *entry)
+{
+    xmlXPathFreeCompExpr(entry->comp);
+    xmlFree(entry->query);
+    heap_free(entry);
+}
+
+static void release_compiled_query(struct xpath_cache_entry *entry)
+{
+    LONG ref;
+
+    EnterCriticalSection(&cs_xpath_cache);
+    ref = --entry->ref;
+    LeaveCriticalSection(&cs_xpath_cache);
+
+    if (!ref)
+        free_xpath_cache_entry(entry);
+}
+
+static struct xpath_cache_entry *get_compiled_query(xmlXPathContextPtr ctxt, const xmlChar *query, BOOL xpath)
+{
+    struct xpath_cache_entry *entry, *evicted = NULL;
+    xmlXPathCompExprPtr comp;
+    BOOL cache;
+
+    /* prefixed names in XSL patterns are translated depending on the namespaces
+     * registered in the context, XPath resolves them on evaluation */
+    cache = xpath || !xmlStrchr(query, ':');
+
+    if (cache)
+    {
+        EnterCriticalSection(&cs_xpath_cache);
+        LIST_FOR_EACH_ENTRY(entry, &xpath_cache, struct xpath_cache_entry, entry)
+        {
+            if (entry->xpath == xpath && xmlStrEqual(entry->query, query))
+            {
+                list_remove(&entry->entry);
+                list_add_head(&xpath_cache, &entry->entry);
+                entry->ref++;
+                LeaveCriticalSection(&cs_xpath_cache);
+                return entry;
+            }
+        }
+        LeaveCriticalSection(&cs_xpath_cache);
+    }
+
+    if (xpath)
+        comp = xmlXPathCtxtCompile(ctxt, query);
+    else
+    {
+        xmlChar *pattern_query = XSLPattern_to_XPath(ctxt, query);
+
+        comp = pattern_query ? xmlXPathCtxtCompile(ctxt, pattern_query) : NULL;
+        xmlFree(pattern_query);
+    }
+    if (!comp)
+        return NULL;
+
+    entry = heap_alloc(sizeof(*entry));
+    if (entry)
+        entry->query = xmlStrdup(query);
+    if (!entry || !entry->query)
+    {
+        heap_free(entry);
+        xmlXPathFreeCompExpr(comp);
+        return NULL;
+    }
+
+    entry->ref = 1;
+    entry->xpath = xpath;
+    entry->comp = comp;
+
+    if (cache)
+    {
+        EnterCriticalSection(&cs_xpath_cache);
+        entry->ref++;
+        list_add_head(&xpath_cache, &entry->entry);
+        if (++xpath_cache_count > XPATH_CACHE_SIZE)
+        {
+            evicted = LIST_ENTRY(list_tail(&xpath_cache), struct xpath_cache_entry, entry);
+            list_remove(&evicted->entry);
+            xpath_cache_count--;
+        }
+        LeaveCriticalSection(&cs_xpath_cache);
+
+        if (evicted)
+            release_compiled_query(evicted);
+    }
+
+    return entry;
+}
+
+void release_xpath_cache(void)
+{
+    struct xpath_cache_entry *entry, *entry2;
+
+    LIST_FOR_EACH_ENTRY_SAFE(entry, entry2, &xpath_cache, struct xpath_cache_entry, entry)
+    {
+        list_remove(&entry->entry);
+        release_compiled_query(entry);
+    }
+    xpath_cache_count = 0;
+}
+#endif
+
 typedef struct
 {
     IEnumVARIANT IEnumVARIANT_iface;
@@ -769,6 +900,9 @@ HRESULT create_selection(xmlNodePtr node, xmlChar* query, IXMLDOMNodeList **out)
 {
     domselection *This = heap_alloc(sizeof(domselection));
     xmlXPathContextPtr ctxt = xmlXPathNewContext(node->doc);
+#ifdef __REACTOS__
+    struct xpath_cache_entry *compiled;
+#endif
     HRESULT hr;
 
     TRACE("(%p, %s, %p)\n", node, debugstr_a((char const*)query), out);
@@ -796,11 +930,17 @@ HRESULT create_selection(xmlNodePtr node, xmlChar* query, IXMLDOMNodeList **out)
     if (is_xpathmode(This->node->doc))
     {
         xmlXPathRegisterAllFunctions(ctxt);
+#ifdef __REACTOS__
+    }
+    else
+    {
+#else
         This->result = xmlXPathEvalExpression(query, ctxt);
     }
     else
     {
         xmlChar* pattern_query = XSLPattern_to_XPath(ctxt, query);
+#endif
 
         xmlXPathRegisterFunc(ctxt, (xmlChar const*)"not", xmlXPathNotFunction);
         xmlXPathRegisterFunc(ctxt, (xmlChar const*)"boolean", xmlXPathBooleanFunction);
@@ -815,10 +955,22 @@ HRESULT create_selection(xmlNodePtr node, xmlChar* query, IXMLDOMNodeList **out)
         xmlXPathRegisterFunc(ctxt, (xmlChar const*)"OP_ILEq", XSLPattern_OP_ILEq);
         xmlXPathRegisterFunc(ctxt, (xmlChar const*)"OP_IGt", XSLPattern_OP_IGt);
         xmlXPathRegisterFunc(ctxt, (xmlChar const*)"OP_IGEq", XSLPattern_OP_IGEq);
+#ifdef __REACTOS__
+    }
 
+    compiled = get_compiled_query(ctxt, query, is_xpathmode(This->node->doc));
+    if (compiled)
+    {
+        This->result = xmlXPathCompiledEval(compiled->comp, ctxt);
+        release_compiled_query(compiled);
+    }
+    else
+        This->result = NULL;
+#else
         This->result = xmlXPathEvalExpression(pattern_query, ctxt);
         xmlFree(pattern_query);
     }
+#endif
 
     if (!This->result || This->result->type != XPATH_NODESET)
     {
@@ -4029,7 +4029,11 @@ static HRESULT StorageImpl_GetNextBlockInChain(
   BYTE depotBuffer[MAX_BIG_BLOCK_SIZE];
   ULONG read;
   ULONG depotBlockIndexPos;
+#ifdef __REACTOS__
+  int index, num_blocks, cache, oldest;
+#else
   int index, num_blocks;
+#endif
 
   *nextBlockIndex   = BLOCK_SPECIAL;
 
@@ -4040,12 +4044,36 @@ static HRESULT StorageImpl_GetNextBlockInChain(
     return STG_E_READFAULT;
   }
 
+#ifdef __REACTOS__
+  /*
+   * Look for the depot block in the cache, and remember the least recently
+   * used entry in case it isn't there.
+   */
+  oldest = 0;
+  for (cache = 0; cache < BLOCKDEPOT_CACHE_SIZE; cache++)
+  {
+    if (This->indexBlockDepotCached[cache] == depotBlockCount)
+      break;
+
+    if (This->blockDepotCacheAge[cache] < This->blockDepotCacheAge[oldest])
+      oldest = cache;
+  }
+
+  /*
+   * Cache the currently accessed depot block.
+   */
+  if (cache == BLOCKDEPOT_CACHE_SIZE)
+  {
+    cache = oldest;
+    This->indexBlockDepotCached[cache] = 0xFFFFFFFF;
+#else
   /*
    * Cache the currently accessed depot block.
    */
   if (depotBlockCount != This->indexBlockDepotCached)
   {
     This->indexBlockDepotCached = depotBlockCount;
+#endif
 
     if (depotBlockCount < COUNT_BBDEPOTINHEADER)
     {
@@ -4069,11 +4097,23 @@ static HRESULT StorageImpl_GetNextBlockInChain(
     for (index = 0; index < num_blocks; index++)
     {
       StorageUtl_ReadDWord(depotBuffer, index*sizeof(ULONG), nextBlockIndex);
+#ifdef __REACTOS__
+      This->blockDepotCached[cache][index] = *nextBlockIndex;
+    }
+
+    This->indexBlockDepotCached[cache] = depotBlockCount;
+  }
+
+  This->blockDepotCacheAge[cache] = ++This->blockDepotCacheClock;
+
+  *nextBlockIndex = This->blockDepotCached[cache][depotBlockOffset/sizeof(ULONG)];
+#else
       This->blockDepotCached[index] = *nextBlockIndex;
     }
   }
 
   *nextBlockIndex = This->blockDepotCached[depotBlockOffset/sizeof(ULONG)];
+#endif
 
   return S_OK;
 }
@@ -4127,6 +4167,9 @@ static void StorageImpl_SetNextBlockInChain(
   ULONG depotBlockCount  = offsetInDepot / This->bigBlockSize;
   ULONG depotBlockOffset = offsetInDepot % This->bigBlockSize;
   ULONG depotBlockIndexPos;
+#ifdef __REACTOS__
+  int cache;
+#endif
 
   assert(depotBlockCount < This->bigBlockDepotCount);
   assert(blockIndex != nextBlock);
@@ -4155,10 +4198,21 @@ static void StorageImpl_SetNextBlockInChain(
   /*
    * Update the cached block depot, if necessary.
    */
+#ifdef __REACTOS__
+  for (cache = 0; cache < BLOCKDEPOT_CACHE_SIZE; cache++)
+  {
+    if (depotBlockCount == This->indexBlockDepotCached[cache])
+    {
+      This->blockDepotCached[cache][depotBlockOffset/sizeof(ULONG)] = nextBlock;
+      break;
+    }
+  }
+#else
   if (depotBlockCount == This->indexBlockDepotCached)
   {
     This->blockDepotCached[depotBlockOffset/sizeof(ULONG)] = nextBlock;
   }
+#endif
 }
 
 /******************************************************************************
@@ -4626,6 +4680,9 @@ static HRESULT StorageImpl_Refresh(StorageImpl *This, BOOL new_object, BOOL crea
   DirEntry currentEntry;
   DirRef      currentEntryRef;
   BlockChainStream *blockChainStream;
+#ifdef __REACTOS__
+  int cache;
+#endif
 
   if (create)
   {
@@ -4692,7 +4749,16 @@ static HRESULT StorageImpl_Refresh(StorageImpl *This, BOOL new_object, BOOL crea
   /*
    * There is no block depot cached yet.
    */
+#ifdef __REACTOS__
+  for (cache = 0; cache < BLOCKDEPOT_CACHE_SIZE; cache++)
+  {
+    This->indexBlockDepotCached[cache] = 0xFFFFFFFF;
+    This->blockDepotCacheAge[cache] = 0;
+  }
+  This->blockDepotCacheClock = 0;
+#else
   This->indexBlockDepotCached = 0xFFFFFFFF;
+#endif
   This->indexExtBlockDepotCached = 0xFFFFFFFF;
 
   /*
@@ -7258,6 +7324,32 @@ static HRESULT BlockChainStream_GetBlockAtOffset(BlockChainStream *This,
   return S_OK;
 }
 
+#ifdef __REACTOS__
+/* Counts how many of the blocks following index (up to max_blocks in total)
+ * are stored in consecutive sectors after sector and are not cached, so that
+ * they can be transferred with a single call to the underlying ILockBytes. */
+static ULONG BlockChainStream_GetContiguousBlocks(BlockChainStream *This,
+    ULONG index, ULONG sector, ULONG max_blocks)
+{
+  ULONG count = 1;
+  int i;
+
+  while (count < max_blocks)
+  {
+    for (i=0; i<2; i++)
+      if (This->cachedBlocks[i].index == index + count)
+        return count;
+
+    if (BlockChainStream_GetSectorOfOffset(This, index + count) != sector + count)
+      break;
+
+    count++;
+  }
+
+  return count;
+}
+#endif
+
 BlockChainStream* BlockChainStream_Construct(
   StorageImpl* parentStorage,
   ULONG*         headOfStreamPlaceHolder,
@@ -7611,7 +7703,11 @@ HRESULT BlockChainStream_ReadAt(BlockChainStream* This,
   ULONG blockNoInSequence = offset.QuadPart / This->parentStorage->bigBlockSize;
   ULONG offsetInBlock     = offset.QuadPart % This->parentStorage->bigBlockSize;
   ULONG bytesToReadInBuffer;
+#ifdef __REACTOS__
+  ULONG blockIndex, blockCount;
+#else
   ULONG blockIndex;
+#endif
   BYTE* bufferWalker;
   ULARGE_INTEGER stream_size;
   HRESULT hr;
@@ -7653,9 +7749,21 @@ HRESULT BlockChainStream_ReadAt(BlockChainStream* This,
     if (FAILED(hr))
       return hr;
 
+#ifdef __REACTOS__
+    blockCount = 1;
+
+    if (!cachedBlock)
+    {
+      /* Not in cache, and we're going to read past the end of the block.
+       * Read the whole blocks that follow it on disk at the same time. */
+      blockCount = BlockChainStream_GetContiguousBlocks(This, blockNoInSequence, blockIndex,
+          1 + (size - bytesToReadInBuffer) / This->parentStorage->bigBlockSize);
+      bytesToReadInBuffer += (blockCount - 1) * This->parentStorage->bigBlockSize;
+#else
     if (!cachedBlock)
     {
       /* Not in cache, and we're going to read past the end of the block. */
+#endif
       ulOffset.QuadPart = StorageImpl_GetBigBlockOffset(This->parentStorage, blockIndex) +
                                offsetInBlock;
 
@@ -7680,7 +7788,11 @@ HRESULT BlockChainStream_ReadAt(BlockChainStream* This,
       bytesReadAt = bytesToReadInBuffer;
     }
 
+#ifdef __REACTOS__
+    blockNoInSequence += blockCount;
+#else
     blockNoInSequence++;
+#endif
     bufferWalker += bytesReadAt;
     size         -= bytesReadAt;
     *bytesRead   += bytesReadAt;
@@ -7708,7 +7820,11 @@ HRESULT BlockChainStream_WriteAt(BlockChainStream* This,
   ULONG blockNoInSequence = offset.QuadPart / This->parentStorage->bigBlockSize;
   ULONG offsetInBlock     = offset.QuadPart % This->parentStorage->bigBlockSize;
   ULONG bytesToWrite;
+#ifdef __REACTOS__
+  ULONG blockIndex, blockCount;
+#else
   ULONG blockIndex;
+#endif
   const BYTE* bufferWalker;
   HRESULT hr;
   BlockChainBlock *cachedBlock;
@@ -7737,9 +7853,21 @@ HRESULT BlockChainStream_WriteAt(BlockChainStream* This,
       return hr;
     }
 
+#ifdef __REACTOS__
+    blockCount = 1;
+
+    if (!cachedBlock)
+    {
+      /* Not in cache, and we're going to write past the end of the block.
+       * Write the whole blocks that follow it on disk at the same time. */
+      blockCount = BlockChainStream_GetContiguousBlocks(This, blockNoInSequence, blockIndex,
+          1 + (size - bytesToWrite) / This->parentStorage->bigBlockSize);
+      bytesToWrite += (blockCount - 1) * This->parentStorage->bigBlockSize;
+#else
     if (!cachedBlock)
     {
       /* Not in cache, and we're going to write past the end of the block. */
+#endif
       ulOffset.QuadPart = StorageImpl_GetBigBlockOffset(This->parentStorage, blockIndex) +
                                offsetInBlock;
 
@@ -7764,7 +7892,11 @@ HRESULT BlockChainStream_WriteAt(BlockChainStream* This,
       cachedBlock->dirty = TRUE;
     }
 
+#ifdef __REACTOS__
+    blockNoInSequence += blockCount;
+#else
     blockNoInSequence++;
+#endif
     bufferWalker  += bytesWrittenAt;
     size          -= bytesWrittenAt;
     *bytesWritten += bytesWrittenAt;
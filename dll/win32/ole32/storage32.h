@@ -362,6 +362,11 @@ void StorageBaseImpl_RemoveStream(StorageBaseImpl * stg, StgStreamImpl * strm) D
 /* Number of BlockChainStream objects to cache in a StorageImpl */
 #define BLOCKCHAIN_CACHE_SIZE 4
 
+#ifdef __REACTOS__
+/* Number of big block depot sectors to cache in a StorageImpl */
+#define BLOCKDEPOT_CACHE_SIZE 8
+#endif
+
 /****************************************************************************
  * StorageImpl definitions.
  *
@@ -393,8 +398,15 @@ struct StorageImpl
   ULONG extBlockDepotCached[MAX_BIG_BLOCK_SIZE / 4];
   ULONG indexExtBlockDepotCached;
 
+#ifdef __REACTOS__
+  ULONG blockDepotCached[BLOCKDEPOT_CACHE_SIZE][MAX_BIG_BLOCK_SIZE / 4];
+  ULONG indexBlockDepotCached[BLOCKDEPOT_CACHE_SIZE];
+  ULONG blockDepotCacheAge[BLOCKDEPOT_CACHE_SIZE];
+  ULONG blockDepotCacheClock;
+#else
   ULONG blockDepotCached[MAX_BIG_BLOCK_SIZE / 4];
   ULONG indexBlockDepotCached;
+#endif
   ULONG prevFreeBlock;
 
   /* All small blocks before this one are known to be in use. */
@@ -317,6 +317,29 @@ Quit:
 
     return ErrCode;
 }
+
+/* The pipe security never changes, so build it only once per process */
+static PSECURITY_DESCRIPTOR rpcrt4_pipe_security;
+
+static DWORD rpcrt4_get_pipe_security(PSECURITY_DESCRIPTOR *SecDesc)
+{
+    DWORD ErrCode;
+    PSECURITY_DESCRIPTOR NewSecDesc;
+
+    if (rpcrt4_pipe_security == NULL)
+    {
+        ErrCode = rpcrt4_create_pipe_security(&NewSecDesc);
+        if (ErrCode != ERROR_SUCCESS)
+            return ErrCode;
+
+        /* Another thread may have been faster than us */
+        if (InterlockedCompareExchangePointer(&rpcrt4_pipe_security, NewSecDesc, NULL) != NULL)
+            HeapFree(GetProcessHeap(), 0, NewSecDesc);
+    }
+
+    *SecDesc = rpcrt4_pipe_security;
+    return ERROR_SUCCESS;
+}
 #endif
 
 static RPC_STATUS rpcrt4_conn_create_pipe(RpcConnection *conn)
@@ -331,7 +354,7 @@ static RPC_STATUS rpcrt4_conn_create_pipe(RpcConnection *conn)
     TRACE("listening on %s\n", connection->listen_pipe);
 
 #ifdef __REACTOS__
-    ErrCode = rpcrt4_create_pipe_security(&PipeSecDesc);
+    ErrCode = rpcrt4_get_pipe_security(&PipeSecDesc);
     if (ErrCode != ERROR_SUCCESS)
     {
         ERR("rpcrt4_conn_create_pipe(): Pipe security descriptor creation failed!\n");
@@ -346,7 +369,6 @@ static RPC_STATUS rpcrt4_conn_create_pipe(RpcConnection *conn)
                                         PIPE_TYPE_MESSAGE | PIPE_READMODE_MESSAGE,
                                         PIPE_UNLIMITED_INSTANCES,
                                         RPC_MAX_PACKET_SIZE, RPC_MAX_PACKET_SIZE, 5000, &SecurityAttributes);
-    HeapFree(GetProcessHeap(), 0, PipeSecDesc);
 #else
     connection->pipe = CreateNamedPipeA(connection->listen_pipe, PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED,
                                         PIPE_TYPE_MESSAGE | PIPE_READMODE_MESSAGE,
@@ -790,6 +812,108 @@ static int rpcrt4_conn_np_wait_for_incoming_data(RpcConnection *conn)
     return rpcrt4_conn_np_read(conn, NULL, 0);
 }
 
+#ifdef __REACTOS__
+static RPC_STATUS rpcrt4_conn_np_receive_fragment(RpcConnection *conn, RpcPktHdr **Header, void **Payload)
+{
+    unsigned char buffer[RPC_MAX_PACKET_SIZE];
+    const RpcPktCommonHdr *common_hdr = (const RpcPktCommonHdr *)buffer;
+    RPC_STATUS status;
+    DWORD hdr_length, payload_length, payload_read;
+    LONG dwRead;
+
+    *Header = NULL;
+    *Payload = NULL;
+
+    TRACE("(%p, %p, %p)\n", conn, Header, Payload);
+
+    /* The pipe is in message mode and each fragment is sent with a single
+     * write, so the whole fragment normally comes with a single read instead
+     * of one read for the common header, the rest of the header and the data */
+    dwRead = rpcrt4_conn_np_read(conn, buffer, sizeof(buffer));
+    if (dwRead < (LONG)sizeof(*common_hdr))
+    {
+        WARN("Short read of header, %d bytes\n", dwRead);
+        status = RPC_S_CALL_FAILED;
+        goto fail;
+    }
+
+    status = RPCRT4_ValidateCommonHeader(common_hdr);
+    if (status != RPC_S_OK) goto fail;
+
+    hdr_length = RPCRT4_GetHeaderSize((const RpcPktHdr *)common_hdr);
+    if (hdr_length == 0 || common_hdr->frag_len < hdr_length || dwRead > (LONG)common_hdr->frag_len)
+    {
+        WARN("bad fragment, read %d bytes, hdr_length %d, frag_len %d\n",
+             dwRead, hdr_length, common_hdr->frag_len);
+        status = RPC_S_PROTOCOL_ERROR;
+        goto fail;
+    }
+    payload_length = common_hdr->frag_len - hdr_length;
+
+    *Header = HeapAlloc(GetProcessHeap(), 0, hdr_length);
+    if (!*Header)
+    {
+        status = RPC_S_OUT_OF_RESOURCES;
+        goto fail;
+    }
+
+    if (payload_length)
+    {
+        *Payload = HeapAlloc(GetProcessHeap(), 0, payload_length);
+        if (!*Payload)
+        {
+            status = RPC_S_OUT_OF_RESOURCES;
+            goto fail;
+        }
+    }
+
+    if ((DWORD)dwRead < hdr_length)
+    {
+        /* read the rest of packet header */
+        memcpy(*Header, buffer, dwRead);
+        if (rpcrt4_conn_np_read(conn, (unsigned char *)*Header + dwRead, hdr_length - dwRead) != (LONG)(hdr_length - dwRead))
+        {
+            WARN("bad header length, hdr_length %d\n", hdr_length);
+            status = RPC_S_CALL_FAILED;
+            goto fail;
+        }
+        payload_read = 0;
+    }
+    else
+    {
+        memcpy(*Header, buffer, hdr_length);
+        payload_read = dwRead - hdr_length;
+        if (payload_read)
+            memcpy(*Payload, buffer + hdr_length, payload_read);
+    }
+
+    if (payload_read < payload_length)
+    {
+        /* read the rest of the data */
+        dwRead = rpcrt4_conn_np_read(conn, (unsigned char *)*Payload + payload_read, payload_length - payload_read);
+        if (dwRead != (LONG)(payload_length - payload_read))
+        {
+            WARN("bad data length, %d/%d\n", dwRead, payload_length - payload_read);
+            status = RPC_S_CALL_FAILED;
+            goto fail;
+        }
+    }
+
+    /* success */
+    status = RPC_S_OK;
+
+fail:
+    if (status != RPC_S_OK)
+    {
+        RPCRT4_FreeHeader(*Header);
+        *Header = NULL;
+        HeapFree(GetProcessHeap(), 0, *Payload);
+        *Payload = NULL;
+    }
+    return status;
+}
+#endif
+
 static size_t rpcrt4_ncacn_np_get_top_of_tower(unsigned char *tower_data,
                                                const char *networkaddr,
                                                const char *endpoint)
@@ -3501,7 +3625,11 @@ static const struct connection_ops conn_protseq_list[] = {
     rpcrt4_conn_np_wait_for_incoming_data,
     rpcrt4_ncalrpc_get_top_of_tower,
     rpcrt4_ncalrpc_parse_top_of_tower,
+#ifdef __REACTOS__
+    rpcrt4_conn_np_receive_fragment,
+#else
     NULL,
+#endif
     rpcrt4_ncalrpc_is_authorized,
     rpcrt4_ncalrpc_authorize,
     rpcrt4_ncalrpc_secure_packet,
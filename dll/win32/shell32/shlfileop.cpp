@@ -35,6 +35,14 @@ WINE_DEFAULT_DEBUG_CHANNEL(shell);
 
 #define NEW_FILENAME_ON_COPY_TRIES 100
 
+/* Minimal delay in ms between two updates of the progress dialog */
+#define PROGRESS_UPDATE_INTERVAL 100
+
+/* Files up to this size are copied concurrently, by at most COPY_MAX_THREADS threads */
+#define COPY_SMALL_FILE_SIZE (256 * 1024)
+#define COPY_MIN_BATCH 8
+#define COPY_MAX_THREADS 4
+
 typedef struct
 {
     SHFILEOPSTRUCTW *req;
@@ -44,6 +52,12 @@ typedef struct
     IProgressDialog *progress;
     ULARGE_INTEGER completedSize;
     ULARGE_INTEGER totalSize;
+    CRITICAL_SECTION csTotalSize; /* totalSize is computed by the count thread */
+    HANDLE hCountThread;
+    BOOL bCountStop;
+    DWORD dwProgressTicks;
+    DWORD dwTextTicks;
+    BOOL bDeferNotify; /* per-file notifications are sent as one SHCNE_UPDATEDIR */
     WCHAR szBuilderString[50];
 } FILE_OPERATION;
 
@@ -58,6 +72,7 @@ typedef struct
     BOOL bFromWildcard;
     BOOL bFromRelative;
     BOOL bExists;
+    ULARGE_INTEGER size;
 } FILE_ENTRY;
 
 typedef struct
@@ -80,7 +95,10 @@ static HRESULT copy_files(FILE_OPERATION *op, BOOL multiDest, const FILE_LIST *f
 static DWORD move_files(FILE_OPERATION *op, BOOL multiDest, const FILE_LIST *flFrom, const FILE_LIST *flTo);
 
 DWORD WINAPI _FileOpCountManager(FILE_OPERATION *op, const FILE_LIST *flFrom);
-static BOOL _FileOpCount(FILE_OPERATION *op, LPWSTR pwszBuf, BOOL bFolder, DWORD *ticks);
+static BOOL _FileOpCount(FILE_OPERATION *op, LPWSTR pwszBuf, BOOL bFolder);
+static void _FileOpStartCount(FILE_OPERATION *op, const FILE_LIST *flFrom);
+static void _FileOpStopCount(FILE_OPERATION *op);
+static ULONGLONG _FileOpGetTotalSize(FILE_OPERATION *op);
 
 /* Confirm dialogs with an optional "Yes To All" as used in file operations confirmations
  */
@@ -508,6 +526,12 @@ static void _SetOperationTitle(FILE_OPERATION *op) {
 static void _SetOperationTexts(FILE_OPERATION *op, LPCWSTR src, LPCWSTR dest) {
     if (op->progress == NULL || src == NULL)
         return;
+
+    /* Don't redraw the dialog for each one of many small files */
+    if (GetTickCount() - op->dwTextTicks < PROGRESS_UPDATE_INTERVAL)
+        return;
+    op->dwTextTicks = GetTickCount();
+
     LPWSTR fileSpecS, pathSpecS, fileSpecD, pathSpecD;
     WCHAR szFolderS[50], szFolderD[50], szFinalString[260];
 
@@ -577,10 +601,15 @@ DWORD CALLBACK SHCopyProgressRoutine(
         if (dwCallbackReason & CALLBACK_STREAM_SWITCH)
             op->completedSize.QuadPart += TotalFileSize.QuadPart;
 
+        /* Don't flood the dialog with updates, the chunks and files can be small */
+        if (GetTickCount() - op->dwProgressTicks < PROGRESS_UPDATE_INTERVAL)
+            return 0;
+        op->dwProgressTicks = GetTickCount();
+
         op->progress->SetProgress64(op->completedSize.QuadPart -
                                     TotalFileSize.QuadPart +
                                     TotalBytesTransferred.QuadPart
-                                  , op->totalSize.QuadPart);
+                                  , _FileOpGetTotalSize(op));
 
 
         op->bCancelled = op->progress->HasUserCancelled();
@@ -812,7 +841,8 @@ static DWORD SHNotifyCopyFileW(FILE_OPERATION *op, LPCWSTR src, LPCWSTR dest, BO
             SetFileAttributesW(dest, attribs);
         }
 
-        SHChangeNotify(SHCNE_CREATE, SHCNF_PATHW, dest, NULL);
+        if (!op->bDeferNotify)
+            SHChangeNotify(SHCNE_CREATE, SHCNF_PATHW, dest, NULL);
         return ERROR_SUCCESS;
     }
 
@@ -1195,6 +1225,8 @@ static void parse_wildcard_files(FILE_LIST *flList, LPCWSTR szFile, LPDWORD pdwL
         add_file_to_entry(file, szFullPath);
         file->bFromWildcard = TRUE;
         file->attributes = wfd.dwFileAttributes;
+        file->size.u.LowPart = wfd.nFileSizeLow;
+        file->size.u.HighPart = wfd.nFileSizeHigh;
 
         if (IsAttribDir(file->attributes))
             flList->bAnyDirectories = TRUE;
@@ -1321,10 +1353,173 @@ static CStringW try_find_new_name(LPCWSTR szDestPath)
     return CStringW();
 }
 
+typedef struct
+{
+    FILE_OPERATION *op;
+    const FILE_LIST *flFrom;
+    LPCWSTR szDestDir;
+    DWORD *pdwFiles;
+    DWORD dwNumFiles;
+    LONG lNextFile;
+    BOOL bFromCdRom;
+    BOOL *pbCopied;
+    CRITICAL_SECTION csCopied;
+    ULARGE_INTEGER copiedSize;
+} COPY_BATCH;
+
+static DWORD WINAPI copy_batch_thread(LPVOID lpParameter)
+{
+    COPY_BATCH *batch = (COPY_BATCH *)lpParameter;
+    const FILE_ENTRY *feFrom;
+    WCHAR szTo[MAX_PATH];
+    DWORD attribs, error;
+    LONG i;
+
+    while (!batch->op->bCancelled)
+    {
+        i = InterlockedIncrement(&batch->lNextFile) - 1;
+        if (i >= (LONG)batch->dwNumFiles)
+            break;
+
+        feFrom = &batch->flFrom->feFiles[batch->pdwFiles[i]];
+        PathCombineW(szTo, batch->szDestDir, feFrom->szFilename);
+
+        if (!CopyFileExW(feFrom->szFullPath, szTo, NULL, NULL, &batch->op->bCancelled,
+                         COPY_FILE_FAIL_IF_EXISTS))
+        {
+            /* Leave the file to copy_files, which reports the error */
+            error = GetLastError();
+            if (error != ERROR_FILE_EXISTS && error != ERROR_ALREADY_EXISTS)
+                DeleteFileW(szTo);
+            continue;
+        }
+
+        // We are copying from a CD-ROM volume, which is readonly
+        if (batch->bFromCdRom)
+        {
+            attribs = GetFileAttributesW(szTo);
+            attribs &= ~FILE_ATTRIBUTE_READONLY;
+            SetFileAttributesW(szTo, attribs);
+        }
+
+        batch->pbCopied[batch->pdwFiles[i]] = TRUE;
+
+        EnterCriticalSection(&batch->csCopied);
+        batch->copiedSize.QuadPart += feFrom->size.QuadPart;
+        LeaveCriticalSection(&batch->csCopied);
+    }
+
+    return 0;
+}
+
+/*
+ * Copies the small files of flFrom to the newly created directory szDestDir
+ * using several threads, and removes them from the list. As the directory is
+ * new, there can't be any collision to ask the user about; the files that
+ * fail to copy are kept in the list, for copy_files to retry and report.
+ */
+static void copy_small_files(FILE_OPERATION *op, FILE_LIST *flFrom, LPCWSTR szDestDir)
+{
+    COPY_BATCH batch;
+    HANDLE hThreads[COPY_MAX_THREADS];
+    DWORD i, j, dwNumThreads, dwMaxThreads;
+    const FILE_ENTRY *feFrom;
+    ULARGE_INTEGER copiedSize;
+
+    ZeroMemory(&batch, sizeof(batch));
+    batch.op = op;
+    batch.flFrom = flFrom;
+    batch.szDestDir = szDestDir;
+
+    if (flFrom->dwNumFiles < COPY_MIN_BATCH)
+        return;
+
+    batch.pdwFiles = (DWORD *)HeapAlloc(GetProcessHeap(), 0, flFrom->dwNumFiles * sizeof(DWORD));
+    batch.pbCopied = (BOOL *)HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, flFrom->dwNumFiles * sizeof(BOOL));
+    if (!batch.pdwFiles || !batch.pbCopied)
+        goto cleanup;
+
+    for (i = 0; i < flFrom->dwNumFiles; i++)
+    {
+        feFrom = &flFrom->feFiles[i];
+        if (feFrom->bFromWildcard && IsAttribFile(feFrom->attributes) &&
+            feFrom->size.QuadPart <= COPY_SMALL_FILE_SIZE)
+        {
+            batch.pdwFiles[batch.dwNumFiles++] = i;
+        }
+    }
+
+    if (batch.dwNumFiles < COPY_MIN_BATCH)
+        goto cleanup;
+
+    batch.bFromCdRom = SHIsCdRom(flFrom->feFiles[batch.pdwFiles[0]].szFullPath);
+    InitializeCriticalSection(&batch.csCopied);
+
+    dwMaxThreads = batch.dwNumFiles / COPY_MIN_BATCH;
+    if (dwMaxThreads > COPY_MAX_THREADS)
+        dwMaxThreads = COPY_MAX_THREADS;
+
+    for (dwNumThreads = 0; dwNumThreads < dwMaxThreads; dwNumThreads++)
+    {
+        hThreads[dwNumThreads] = CreateThread(NULL, 0, copy_batch_thread, &batch, 0, NULL);
+        if (!hThreads[dwNumThreads])
+            break;
+    }
+
+    if (dwNumThreads == 0)
+        copy_batch_thread(&batch);
+
+    /* Keep the progress dialog alive while the threads are copying */
+    while (dwNumThreads &&
+           WaitForMultipleObjects(dwNumThreads, hThreads, TRUE, PROGRESS_UPDATE_INTERVAL) == WAIT_TIMEOUT)
+    {
+        if (op->progress == NULL)
+            continue;
+
+        EnterCriticalSection(&batch.csCopied);
+        copiedSize = batch.copiedSize;
+        LeaveCriticalSection(&batch.csCopied);
+
+        op->progress->SetProgress64(op->completedSize.QuadPart + copiedSize.QuadPart,
+                                    _FileOpGetTotalSize(op));
+        op->bCancelled |= op->progress->HasUserCancelled();
+    }
+
+    /* The wait above may have failed, make sure no thread still uses the batch */
+    for (i = 0; i < dwNumThreads; i++)
+    {
+        WaitForSingleObject(hThreads[i], INFINITE);
+        CloseHandle(hThreads[i]);
+    }
+    DeleteCriticalSection(&batch.csCopied);
+
+    op->completedSize.QuadPart += batch.copiedSize.QuadPart;
+
+    /* Remove the copied files from the list */
+    for (i = 0, j = 0; i < flFrom->dwNumFiles; i++)
+    {
+        if (batch.pbCopied[i])
+        {
+            HeapFree(GetProcessHeap(), 0, flFrom->feFiles[i].szDirectory);
+            HeapFree(GetProcessHeap(), 0, flFrom->feFiles[i].szFilename);
+            HeapFree(GetProcessHeap(), 0, flFrom->feFiles[i].szFullPath);
+            continue;
+        }
+
+        flFrom->feFiles[j++] = flFrom->feFiles[i];
+    }
+    flFrom->dwNumFiles = j;
+
+cleanup:
+    HeapFree(GetProcessHeap(), 0, batch.pdwFiles);
+    HeapFree(GetProcessHeap(), 0, batch.pbCopied);
+}
+
 static void copy_dir_to_dir(FILE_OPERATION *op, const FILE_ENTRY *feFrom, LPCWSTR szDestPath)
 {
     WCHAR szFrom[MAX_PATH], szTo[MAX_PATH];
     FILE_LIST flFromNew, flToNew;
+    BOOL bNewDir, bDeferNotify;
 
     if (feFrom->szFilename && IsDotDir(feFrom->szFilename))
         return;
@@ -1357,7 +1552,8 @@ static void copy_dir_to_dir(FILE_OPERATION *op, const FILE_ENTRY *feFrom, LPCWST
     }
 
     szTo[lstrlenW(szTo) + 1] = '\0';
-    SHNotifyCreateDirectoryW(szTo, NULL);
+    bNewDir = !PathFileExistsW(szTo) &&
+              SHNotifyCreateDirectoryW(szTo, NULL) == ERROR_SUCCESS;
 
     PathCombineW(szFrom, feFrom->szFullPath, L"*.*");
     szFrom[lstrlenW(szFrom) + 1] = '\0';
@@ -1367,7 +1563,18 @@ static void copy_dir_to_dir(FILE_OPERATION *op, const FILE_ENTRY *feFrom, LPCWST
     parse_file_list(&flFromNew, szFrom);
     parse_file_list(&flToNew, szTo);
 
-    copy_files(op, FALSE, &flFromNew, &flToNew);
+    /* The contents of the directory are notified all at once */
+    bDeferNotify = op->bDeferNotify;
+    op->bDeferNotify = TRUE;
+
+    if (bNewDir)
+        copy_small_files(op, &flFromNew, szTo);
+
+    if (!op->bCancelled)
+        copy_files(op, FALSE, &flFromNew, &flToNew);
+
+    op->bDeferNotify = bDeferNotify;
+    SHChangeNotify(SHCNE_UPDATEDIR, SHCNF_PATHW, szTo, NULL);
 
     destroy_file_list(&flFromNew);
     destroy_file_list(&flToNew);
@@ -2014,6 +2221,7 @@ int WINAPI SHFileOperationW(LPSHFILEOPSTRUCTW lpFileOp)
     op.totalSize.QuadPart = 0ull;
     op.completedSize.QuadPart = 0ull;
     op.bManyItems = (flFrom.dwNumFiles > 1);
+    InitializeCriticalSection(&op.csTotalSize);
 
     ret = validate_operation(lpFileOp, &flFrom, &flTo);
     if (ret)
@@ -2029,7 +2237,7 @@ int WINAPI SHFileOperationW(LPSHFILEOPSTRUCTW lpFileOp)
 
         op.progress->StartProgressDialog(op.req->hwnd, NULL, PROGDLG_NORMAL & PROGDLG_AUTOTIME, NULL);
         _SetOperationTitle(&op);
-        _FileOpCountManager(&op, &flFrom);
+        _FileOpStartCount(&op, &flFrom);
     }
 
     switch (lpFileOp->wFunc)
@@ -2051,12 +2259,15 @@ int WINAPI SHFileOperationW(LPSHFILEOPSTRUCTW lpFileOp)
             break;
     }
 
+    _FileOpStopCount(&op);
+
     if (op.progress) {
         op.progress->StopProgressDialog();
         op.progress->Release();
     }
 
 cleanup:
+    DeleteCriticalSection(&op.csTotalSize);
     destroy_file_list(&flFrom);
 
     if (lpFileOp->wFunc != FO_DELETE)
@@ -2311,7 +2522,6 @@ EXTERN_C HRESULT WINAPI SHPathPrepareForWriteA(HWND hwnd, IUnknown *modless, LPC
 DWORD WINAPI
 _FileOpCountManager(FILE_OPERATION *op, const FILE_LIST *from)
 {
-    DWORD ticks = GetTickCount();
     FILE_ENTRY *entryToCount;
 
     for (UINT i = 0; i < from->dwNumFiles; i++)
@@ -2320,14 +2530,81 @@ _FileOpCountManager(FILE_OPERATION *op, const FILE_LIST *from)
 
         WCHAR theFileName[MAX_PATH];
         StringCchCopyW(theFileName, MAX_PATH, entryToCount->szFullPath);
-        _FileOpCount(op, theFileName, IsAttribDir(entryToCount->attributes), &ticks);
+        _FileOpCount(op, theFileName, IsAttribDir(entryToCount->attributes));
     }
     return 0;
 }
 
+typedef struct
+{
+    FILE_OPERATION *op;
+    const FILE_LIST *from;
+} FILE_OP_COUNT;
+
+static DWORD WINAPI
+_FileOpCountThread(LPVOID lpParameter)
+{
+    FILE_OP_COUNT *count = (FILE_OP_COUNT *)lpParameter;
+
+    _FileOpCountManager(count->op, count->from);
+
+    HeapFree(GetProcessHeap(), 0, count);
+    return 0;
+}
+
+/*
+ * Counts the total size of the operation in the background, so that the
+ * operation can start right away; the progress bar grows with the count.
+ */
+static void
+_FileOpStartCount(FILE_OPERATION *op, const FILE_LIST *flFrom)
+{
+    FILE_OP_COUNT *count;
+
+    count = (FILE_OP_COUNT *)HeapAlloc(GetProcessHeap(), 0, sizeof(*count));
+    if (count)
+    {
+        count->op = op;
+        count->from = flFrom;
+
+        op->hCountThread = CreateThread(NULL, 0, _FileOpCountThread, count, 0, NULL);
+        if (op->hCountThread)
+            return;
+
+        HeapFree(GetProcessHeap(), 0, count);
+    }
+
+    /* Count synchronously then */
+    _FileOpCountManager(op, flFrom);
+}
+
+static void
+_FileOpStopCount(FILE_OPERATION *op)
+{
+    if (!op->hCountThread)
+        return;
+
+    op->bCountStop = TRUE;
+    WaitForSingleObject(op->hCountThread, INFINITE);
+    CloseHandle(op->hCountThread);
+    op->hCountThread = NULL;
+}
+
+static ULONGLONG
+_FileOpGetTotalSize(FILE_OPERATION *op)
+{
+    ULONGLONG totalSize;
+
+    EnterCriticalSection(&op->csTotalSize);
+    totalSize = op->totalSize.QuadPart;
+    LeaveCriticalSection(&op->csTotalSize);
+
+    return totalSize;
+}
+
 // All path manipulations, even when this function is nested, occur on the one buffer.
 static BOOL
-_FileOpCount(FILE_OPERATION *op, LPWSTR pwszBuf, BOOL bFolder, DWORD *ticks)
+_FileOpCount(FILE_OPERATION *op, LPWSTR pwszBuf, BOOL bFolder)
 {
     /* Find filename position */
     UINT cchBuf = wcslen(pwszBuf);
@@ -2360,25 +2637,21 @@ _FileOpCount(FILE_OPERATION *op, LPWSTR pwszBuf, BOOL bFolder, DWORD *ticks)
                 continue;
 
             StringCchCopyW(pwszFilename, cchFilenameMax, wfd.cFileName);
-            _FileOpCount(op, pwszBuf, TRUE, ticks);
+            _FileOpCount(op, pwszBuf, TRUE);
         }
         else
         {
             ULARGE_INTEGER FileSize;
             FileSize.u.LowPart  = wfd.nFileSizeLow;
             FileSize.u.HighPart = wfd.nFileSizeHigh;
+            EnterCriticalSection(&op->csTotalSize);
             op->totalSize.QuadPart += FileSize.QuadPart;
+            LeaveCriticalSection(&op->csTotalSize);
         }
-        if (GetTickCount() - *ticks > (DWORD) 500)
-        {
-            // Check if the dialog has ended. If it has, we'll spin down.
-            if (op->progress != NULL)
-                op->bCancelled = op->progress->HasUserCancelled();
 
-            if (op->bCancelled)
-                break;
-            *ticks = GetTickCount();
-        }
+        // The operation checks the dialog for cancellation, we just spin down.
+        if (op->bCancelled || op->bCountStop)
+            break;
     } while(FindNextFileW(hFind, &wfd));
 
     FindClose(hFind);
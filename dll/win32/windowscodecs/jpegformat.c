@@ -158,6 +158,11 @@ typedef struct {
     BYTE source_buffer[1024];
     UINT bpp, stride;
     BYTE *image_data;
+#ifdef __REACTOS__
+    ULARGE_INTEGER stream_pos;
+    BOOL decode_failed;
+    UINT allocated_rows;
+#endif
     CRITICAL_SECTION lock;
 } JpegDecoder;
 
@@ -305,7 +310,9 @@ static HRESULT WINAPI JpegDecoder_Initialize(IWICBitmapDecoder *iface, IStream *
     int ret;
     LARGE_INTEGER seek;
     jmp_buf jmpbuf;
+#ifndef __REACTOS__
     UINT data_size, i;
+#endif
 
     TRACE("(%p,%p,%u)\n", iface, pIStream, cacheOptions);
 
@@ -390,6 +397,7 @@ static HRESULT WINAPI JpegDecoder_Initialize(IWICBitmapDecoder *iface, IStream *
     else This->bpp = 24;
 
     This->stride = (This->bpp * This->cinfo.output_width + 7) / 8;
+#ifndef __REACTOS__
     data_size = This->stride * This->cinfo.output_height;
 
     This->image_data = heap_alloc(data_size);
@@ -398,7 +406,15 @@ static HRESULT WINAPI JpegDecoder_Initialize(IWICBitmapDecoder *iface, IStream *
         LeaveCriticalSection(&This->lock);
         return E_OUTOFMEMORY;
     }
+#endif
 
+#ifdef __REACTOS__
+    /* The scanlines are decoded, and the image buffer grown, on demand by
+     * CopyPixels. Remember where libjpeg stopped reading, the stream may
+     * be moved in the meantime. */
+    seek.QuadPart = 0;
+    IStream_Seek(This->stream, seek, STREAM_SEEK_CUR, &This->stream_pos);
+#else
     while (This->cinfo.output_scanline < This->cinfo.output_height)
     {
         UINT first_scanline = This->cinfo.output_scanline;
@@ -433,6 +449,7 @@ static HRESULT WINAPI JpegDecoder_Initialize(IWICBitmapDecoder *iface, IStream *
         for (i=0; i<data_size; i++)
             This->image_data[i] ^= 0xff;
     }
+#endif
 
     This->initialized = TRUE;
 
@@ -441,6 +458,88 @@ static HRESULT WINAPI JpegDecoder_Initialize(IWICBitmapDecoder *iface, IStream *
     return S_OK;
 }
 
+#ifdef __REACTOS__
+/* Decodes the image up to and including last_row, with the lock held */
+static HRESULT JpegDecoder_DecodeRows(JpegDecoder *This, UINT last_row)
+{
+    UINT first_row = This->cinfo.output_scanline;
+    LARGE_INTEGER seek;
+    jmp_buf jmpbuf;
+    UINT i;
+
+    if (This->decode_failed) return E_FAIL;
+    if (last_row < first_row) return S_OK;
+
+    /* libjpeg may output up to 4 rows at once, grow the buffer by at least half */
+    if (last_row + 4 > This->allocated_rows)
+    {
+        UINT rows = max(last_row + 4, This->allocated_rows + This->allocated_rows / 2);
+        BYTE *image_data;
+
+        rows = min(rows, This->cinfo.output_height);
+        image_data = heap_realloc(This->image_data, (SIZE_T)This->stride * rows);
+        if (!image_data) return E_OUTOFMEMORY;
+
+        This->image_data = image_data;
+        This->allocated_rows = rows;
+    }
+
+    seek.QuadPart = This->stream_pos.QuadPart;
+    IStream_Seek(This->stream, seek, STREAM_SEEK_SET, NULL);
+
+    This->cinfo.client_data = jmpbuf;
+
+    if (setjmp(jmpbuf))
+    {
+        This->decode_failed = TRUE;
+        return E_FAIL;
+    }
+
+    while (This->cinfo.output_scanline <= last_row)
+    {
+        UINT first_scanline = This->cinfo.output_scanline;
+        UINT max_rows;
+        JSAMPROW out_rows[4];
+        JDIMENSION ret;
+
+        max_rows = min(This->cinfo.output_height-first_scanline, 4);
+        for (i=0; i<max_rows; i++)
+            out_rows[i] = This->image_data + This->stride * (first_scanline+i);
+
+        ret = pjpeg_read_scanlines(&This->cinfo, out_rows, max_rows);
+        if (ret == 0)
+        {
+            ERR("read_scanlines failed\n");
+            This->decode_failed = TRUE;
+            return E_FAIL;
+        }
+    }
+
+    seek.QuadPart = 0;
+    IStream_Seek(This->stream, seek, STREAM_SEEK_CUR, &This->stream_pos);
+
+    if (This->bpp == 24)
+    {
+        /* libjpeg gives us RGB data and we want BGR, so byteswap the data */
+        reverse_bgr8(3, This->image_data + This->stride * first_row,
+            This->cinfo.output_width, This->cinfo.output_scanline - first_row,
+            This->stride);
+    }
+
+    if (This->cinfo.out_color_space == JCS_CMYK && This->cinfo.saw_Adobe_marker)
+    {
+        BYTE *data = This->image_data + This->stride * first_row;
+        UINT data_size = This->stride * (This->cinfo.output_scanline - first_row);
+
+        /* Adobe JPEG's have inverted CMYK data. */
+        for (i=0; i<data_size; i++)
+            data[i] ^= 0xff;
+    }
+
+    return S_OK;
+}
+#endif
+
 static HRESULT WINAPI JpegDecoder_GetContainerFormat(IWICBitmapDecoder *iface,
     GUID *pguidContainerFormat)
 {
@@ -644,11 +743,43 @@ static HRESULT WINAPI JpegDecoder_Frame_CopyPixels(IWICBitmapFrameDecode *iface,
 {
     JpegDecoder *This = impl_from_IWICBitmapFrameDecode(iface);
 
+#ifdef __REACTOS__
+    UINT last_row;
+    HRESULT hr;
+#endif
+
     TRACE("(%p,%s,%u,%u,%p)\n", iface, debug_wic_rect(prc), cbStride, cbBufferSize, pbBuffer);
 
+#ifdef __REACTOS__
+    EnterCriticalSection(&This->lock);
+
+    /* Only decode as far as the requested rectangle goes */
+    last_row = This->cinfo.output_height - 1;
+    if (prc && prc->Y >= 0 && prc->Height > 0 &&
+        (UINT)prc->Y < This->cinfo.output_height &&
+        (UINT)prc->Height <= This->cinfo.output_height - prc->Y)
+    {
+        last_row = prc->Y + prc->Height - 1;
+    }
+
+    hr = JpegDecoder_DecodeRows(This, last_row);
+    if (SUCCEEDED(hr))
+    {
+        /* Only the decoded rows are allocated; a rectangle past them is
+         * either invalid or made the whole image decode above */
+        hr = copy_pixels(This->bpp, This->image_data,
+            This->cinfo.output_width, This->cinfo.output_scanline, This->stride,
+            prc, cbStride, cbBufferSize, pbBuffer);
+    }
+
+    LeaveCriticalSection(&This->lock);
+
+    return hr;
+#else
     return copy_pixels(This->bpp, This->image_data,
         This->cinfo.output_width, This->cinfo.output_height, This->stride,
         prc, cbStride, cbBufferSize, pbBuffer);
+#endif
 }
 
 static HRESULT WINAPI JpegDecoder_Frame_GetMetadataQueryReader(IWICBitmapFrameDecode *iface,
@@ -785,6 +916,11 @@ HRESULT JpegDecoder_CreateInstance(REFIID iid, void** ppv)
     This->cinfo_initialized = FALSE;
     This->stream = NULL;
     This->image_data = NULL;
+#ifdef __REACTOS__
+    This->stream_pos.QuadPart = 0;
+    This->allocated_rows = 0;
+    This->decode_failed = FALSE;
+#endif
     InitializeCriticalSection(&This->lock);
     This->lock.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": JpegDecoder.lock");
 
@@ -33,6 +33,20 @@
 
 WINE_DEFAULT_DEBUG_CHANNEL(wincodecs);
 
+#ifdef __REACTOS__
+/* The weights of the source pixels of a tap add up to SCALE_ONE */
+#define SCALE_SHIFT 14
+#define SCALE_ONE   (1 << SCALE_SHIFT)
+
+/* Source pixels contributing to one destination row or column */
+struct scale_tap
+{
+    UINT first;            /* first source pixel */
+    UINT count;            /* number of source pixels */
+    const USHORT *weights; /* weight of each source pixel */
+};
+#endif
+
 typedef struct BitmapScaler {
     IWICBitmapScaler IWICBitmapScaler_iface;
     LONG ref;
@@ -44,6 +58,11 @@ typedef struct BitmapScaler {
     UINT bpp;
     void (*fn_get_required_source_rect)(struct BitmapScaler*,UINT,UINT,WICRect*);
     void (*fn_copy_scanline)(struct BitmapScaler*,UINT,UINT,UINT,BYTE**,UINT,UINT,BYTE*);
+#ifdef __REACTOS__
+    struct scale_tap *x_taps, *y_taps;
+    USHORT *row;       /* source row filtered horizontally, 6 bits of fraction */
+    UINT *row_sums;    /* filtered source rows weighted vertically */
+#endif
     CRITICAL_SECTION lock; /* must be held when initialized */
 } BitmapScaler;
 
@@ -108,6 +127,12 @@ static ULONG WINAPI BitmapScaler_Release(IWICBitmapScaler *iface)
         This->lock.DebugInfo->Spare[0] = 0;
         DeleteCriticalSection(&This->lock);
         if (This->source) IWICBitmapSource_Release(This->source);
+#ifdef __REACTOS__
+        HeapFree(GetProcessHeap(), 0, This->x_taps);
+        HeapFree(GetProcessHeap(), 0, This->y_taps);
+        HeapFree(GetProcessHeap(), 0, This->row);
+        HeapFree(GetProcessHeap(), 0, This->row_sums);
+#endif
         HeapFree(GetProcessHeap(), 0, This);
     }
 
@@ -205,6 +230,178 @@ static void NearestNeighbor_CopyScanline(BitmapScaler *This,
     }
 }
 
+#ifdef __REACTOS__
+static void Interpolate_GetRequiredSourceRect(BitmapScaler *This,
+    UINT x, UINT y, WICRect *src_rect)
+{
+    src_rect->X = This->x_taps[x].first;
+    src_rect->Y = This->y_taps[y].first;
+    src_rect->Width = This->x_taps[x].count;
+    src_rect->Height = This->y_taps[y].count;
+}
+
+static void Interpolate_CopyScanline(BitmapScaler *This,
+    UINT dst_x, UINT dst_y, UINT dst_width,
+    BYTE **src_data, UINT src_data_x, UINT src_data_y, BYTE *pbBuffer)
+{
+    UINT bytesperpixel = This->bpp/8;
+    UINT row_size = bytesperpixel * dst_width;
+    const struct scale_tap *y_tap = &This->y_taps[dst_y];
+    const struct scale_tap *x_tap;
+    const BYTE *src;
+    UINT i, j, k, c, sum;
+
+    memset(This->row_sums, 0, row_size * sizeof(*This->row_sums));
+
+    for (j=0; j<y_tap->count; j++)
+    {
+        /* Filter the source row horizontally */
+        for (i=0; i<dst_width; i++)
+        {
+            x_tap = &This->x_taps[dst_x + i];
+            src = src_data[y_tap->first + j - src_data_y] + bytesperpixel * (x_tap->first - src_data_x);
+
+            for (c=0; c<bytesperpixel; c++)
+            {
+                sum = 0;
+                for (k=0; k<x_tap->count; k++)
+                    sum += src[bytesperpixel * k + c] * x_tap->weights[k];
+
+                /* Keep 6 bits of fraction, so that the vertical sums fit in 32 bits */
+                This->row[bytesperpixel * i + c] = (sum + (1 << (SCALE_SHIFT - 7))) >> (SCALE_SHIFT - 6);
+            }
+        }
+
+        /* Then add it with its vertical weight */
+        for (k=0; k<row_size; k++)
+            This->row_sums[k] += This->row[k] * y_tap->weights[j];
+    }
+
+    for (k=0; k<row_size; k++)
+        pbBuffer[k] = (This->row_sums[k] + (1 << (SCALE_SHIFT + 5))) >> (SCALE_SHIFT + 6);
+}
+
+static struct scale_tap *build_scale_taps(UINT src_size, UINT dst_size, BOOL box)
+{
+    struct scale_tap *taps;
+    USHORT *weights;
+    ULONGLONG start, end, pixel_start, pixel_end;
+    LONGLONG pos;
+    UINT i, j, frac, total;
+
+    /* A box covers at most one more source pixel than the ones it starts in */
+    taps = HeapAlloc(GetProcessHeap(), 0, dst_size * sizeof(*taps) +
+                     (box ? src_size + dst_size : 2 * dst_size) * sizeof(*weights));
+    if (!taps) return NULL;
+
+    weights = (USHORT *)(taps + dst_size);
+
+    for (i=0; i<dst_size; i++)
+    {
+        taps[i].weights = weights;
+
+        if (box)
+        {
+            /* Weight every source pixel by the part of it covered by the
+             * destination one, in units of 1/dst_size source pixel */
+            start = (ULONGLONG)i * src_size;
+            end = start + src_size;
+
+            taps[i].first = (UINT)(start / dst_size);
+            taps[i].count = (UINT)((end - 1) / dst_size) - taps[i].first + 1;
+
+            total = 0;
+            for (j=0; j<taps[i].count; j++)
+            {
+                pixel_start = (ULONGLONG)(taps[i].first + j) * dst_size;
+                pixel_end = pixel_start + dst_size;
+
+                weights[j] = (USHORT)((min(end, pixel_end) - max(start, pixel_start)) * SCALE_ONE / src_size);
+                total += weights[j];
+            }
+
+            /* Keep the sum exact despite the rounding */
+            weights[0] += SCALE_ONE - total;
+
+            weights += taps[i].count;
+            continue;
+        }
+
+        /* Interpolate between the two source pixels around the sample point,
+         * which is the center of the destination pixel, in 24.8 fixed point */
+        pos = (LONGLONG)(2 * i + 1) * src_size * 256 / (2 * dst_size) - 128;
+        if (pos < 0) pos = 0;
+
+        taps[i].first = (UINT)(pos >> 8);
+        frac = (UINT)(pos & 0xff);
+        if (taps[i].first >= src_size - 1)
+        {
+            taps[i].first = src_size - 1;
+            frac = 0;
+        }
+
+        weights[0] = (256 - frac) << (SCALE_SHIFT - 8);
+        weights[1] = frac << (SCALE_SHIFT - 8);
+        taps[i].count = frac ? 2 : 1;
+
+        weights += taps[i].count;
+    }
+
+    return taps;
+}
+
+static HRESULT Interpolate_Initialize(BitmapScaler *This, IWICBitmapSource *source,
+    const GUID *src_pixelformat, WICBitmapInterpolationMode mode)
+{
+    HRESULT hr = S_OK;
+
+    /* Interpolation works on 8-bit channels, convert anything else */
+    if (IsEqualGUID(src_pixelformat, &GUID_WICPixelFormat8bppGray) ||
+        IsEqualGUID(src_pixelformat, &GUID_WICPixelFormat24bppBGR) ||
+        IsEqualGUID(src_pixelformat, &GUID_WICPixelFormat24bppRGB) ||
+        IsEqualGUID(src_pixelformat, &GUID_WICPixelFormat32bppBGR) ||
+        IsEqualGUID(src_pixelformat, &GUID_WICPixelFormat32bppBGRA) ||
+        IsEqualGUID(src_pixelformat, &GUID_WICPixelFormat32bppPBGRA))
+    {
+        IWICBitmapSource_AddRef(source);
+        This->source = source;
+    }
+    else
+    {
+        hr = WICConvertBitmapSource(&GUID_WICPixelFormat32bppBGRA, source, &This->source);
+        if (FAILED(hr)) return hr;
+        This->bpp = 32;
+    }
+
+    /* The Fant mode averages whole boxes when shrinking, the other ones
+     * interpolate linearly (cubic is approximated by linear) */
+    This->x_taps = build_scale_taps(This->src_width, This->width,
+                                    mode == WICBitmapInterpolationModeFant && This->src_width > This->width);
+    This->y_taps = build_scale_taps(This->src_height, This->height,
+                                    mode == WICBitmapInterpolationModeFant && This->src_height > This->height);
+    This->row = HeapAlloc(GetProcessHeap(), 0, This->width * (This->bpp/8) * sizeof(*This->row));
+    This->row_sums = HeapAlloc(GetProcessHeap(), 0, This->width * (This->bpp/8) * sizeof(*This->row_sums));
+    if (!This->x_taps || !This->y_taps || !This->row || !This->row_sums)
+    {
+        HeapFree(GetProcessHeap(), 0, This->x_taps);
+        HeapFree(GetProcessHeap(), 0, This->y_taps);
+        HeapFree(GetProcessHeap(), 0, This->row);
+        HeapFree(GetProcessHeap(), 0, This->row_sums);
+        This->x_taps = This->y_taps = NULL;
+        This->row = NULL;
+        This->row_sums = NULL;
+        IWICBitmapSource_Release(This->source);
+        This->source = NULL;
+        return E_OUTOFMEMORY;
+    }
+
+    This->fn_get_required_source_rect = Interpolate_GetRequiredSourceRect;
+    This->fn_copy_scanline = Interpolate_CopyScanline;
+
+    return S_OK;
+}
+#endif
+
 static HRESULT WINAPI BitmapScaler_CopyPixels(IWICBitmapScaler *iface,
     const WICRect *prc, UINT cbStride, UINT cbBufferSize, BYTE *pbBuffer)
 {
@@ -353,6 +550,13 @@ static HRESULT WINAPI BitmapScaler_Initialize(IWICBitmapScaler *iface,
     {
         switch (mode)
         {
+#ifdef __REACTOS__
+        case WICBitmapInterpolationModeLinear:
+        case WICBitmapInterpolationModeCubic:
+        case WICBitmapInterpolationModeFant:
+            hr = Interpolate_Initialize(This, pISource, &src_pixelformat, mode);
+            break;
+#endif
         default:
             FIXME("unsupported mode %i\n", mode);
             /* fall-through */
@@ -529,6 +733,11 @@ HRESULT BitmapScaler_Create(IWICBitmapScaler **scaler)
     This->src_height = 0;
     This->mode = 0;
     This->bpp = 0;
+#ifdef __REACTOS__
+    This->x_taps = This->y_taps = NULL;
+    This->row = NULL;
+    This->row_sums = NULL;
+#endif
     InitializeCriticalSection(&This->lock);
     This->lock.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": BitmapScaler.lock");
 
@@ -63,6 +63,13 @@
 #define NPFS_WAIT_BLOCK_TAG     'tFpN'
 #define NPFS_WRITE_BLOCK_TAG    'wFpN'
 
+//
+// Pending reads up to this size get their buffer locked by the writer that
+// completes them, so that it can copy its data straight into that buffer
+// instead of going through a pool buffer
+//
+#define NPFS_MAX_DIRECT_READ_SIZE   (64 * 1024)
+
 //
 // NPFS bugchecking support
 //
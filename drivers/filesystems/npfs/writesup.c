@@ -15,6 +15,48 @@
 
 /* FUNCTIONS ******************************************************************/
 
+static
+PVOID
+NpMapPendingReadBuffer(IN PIRP ReadIrp,
+                       IN ULONG Length)
+{
+    PEPROCESS Process;
+    KAPC_STATE ApcState;
+    PMDL Mdl;
+    PAGED_CODE();
+
+    /*
+     * The reader's pages are only locked now, while its data is being
+     * delivered, and get unlocked by the I/O manager when the IRP completes.
+     * An idle pending read thus never keeps any of its pages pinned.
+     */
+    if (Length > NPFS_MAX_DIRECT_READ_SIZE || ReadIrp->MdlAddress) return NULL;
+
+    Process = IoGetRequestorProcess(ReadIrp);
+    if (!Process) return NULL;
+
+    Mdl = IoAllocateMdl(ReadIrp->UserBuffer, Length, FALSE, FALSE, ReadIrp);
+    if (!Mdl) return NULL;
+
+    KeStackAttachProcess((PKPROCESS)Process, &ApcState);
+    _SEH2_TRY
+    {
+        MmProbeAndLockPages(Mdl, ReadIrp->RequestorMode, IoWriteAccess);
+    }
+    _SEH2_EXCEPT(EXCEPTION_EXECUTE_HANDLER)
+    {
+        ReadIrp->MdlAddress = NULL;
+        IoFreeMdl(Mdl);
+        Mdl = NULL;
+    }
+    _SEH2_END;
+    KeUnstackDetachProcess(&ApcState);
+
+    if (!Mdl) return NULL;
+
+    return MmGetSystemAddressForMdlSafe(Mdl, NormalPagePriority);
+}
+
 NTSTATUS
 NTAPI
 NpWriteDataQueue(IN PNP_DATA_QUEUE WriteQueue,
@@ -80,7 +122,19 @@ NpWriteDataQueue(IN PNP_DATA_QUEUE WriteQueue,
         BufferSize = *BytesNotWritten;
         if (BufferSize >= DataSize) BufferSize = DataSize;
 
-        if (DataEntry->DataEntryType != Unbuffered && BufferSize)
+        /* Copy straight into the buffer of a pending read if it can be locked */
+        Buffer = NULL;
+        if (DataEntry->DataEntryType != Unbuffered && BufferSize &&
+            IoStack->MajorFunction == IRP_MJ_READ)
+        {
+            Buffer = NpMapPendingReadBuffer(DataEntry->Irp, BufferSize);
+        }
+
+        if (Buffer)
+        {
+            AllocatedBuffer = FALSE;
+        }
+        else if (DataEntry->DataEntryType != Unbuffered && BufferSize)
         {
             Buffer = ExAllocatePoolWithTag(NonPagedPool, BufferSize, NPFS_DATA_ENTRY_TAG);
             if (!Buffer) return STATUS_INSUFFICIENT_RESOURCES;
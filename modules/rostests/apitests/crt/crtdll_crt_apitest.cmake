@@ -427,10 +427,10 @@ list(APPEND SOURCE_CRTDLL
     mbstowcs.c
     mbtowc.c
 #    memchr.c
-#    memcmp.c
-#    memcpy.c
-#    memmove.c
-#    memset.c
+    memcmp.c
+    memcpy.c
+    memmove.c
+    memset.c
 #    mktime.c
 #    modf.c
 #    perror.c
@@ -0,0 +1,91 @@
+/*
+ * PROJECT:     ReactOS api tests
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     Tests and throughput measurement for memcmp
+ */
+
+#include <apitest.h>
+
+#include <string.h>
+
+#define MAX_LENGTH      (3 * sizeof(size_t))
+#define BUFFER_SIZE     (MAX_LENGTH + 2 * sizeof(size_t))
+
+#define BENCH_SIZE      4096
+#define BENCH_LOOPS     100000
+
+static unsigned char Buffer1[BUFFER_SIZE];
+static unsigned char Buffer2[BUFFER_SIZE];
+static unsigned char BenchBuffer1[BENCH_SIZE + sizeof(size_t)];
+static unsigned char BenchBuffer2[BENCH_SIZE + sizeof(size_t)];
+
+static
+void
+FillPattern(unsigned char *Buffer, size_t Size, unsigned char Seed)
+{
+    size_t i;
+
+    for (i = 0; i < Size; i++)
+        Buffer[i] = (unsigned char)(Seed + i * 7 + 1);
+}
+
+START_TEST(memcmp)
+{
+    size_t Align1, Align2, Length, Pos;
+    unsigned char *Ptr1, *Ptr2;
+    volatile int Result = 0;
+    DWORD StartTime;
+    ULONG i;
+
+    for (Align1 = 0; Align1 < sizeof(size_t); Align1++)
+    {
+        for (Align2 = 0; Align2 < sizeof(size_t); Align2++)
+        {
+            for (Length = 0; Length <= MAX_LENGTH; Length++)
+            {
+                /* Equal contents, different bytes right after them */
+                Ptr1 = Buffer1 + Align1;
+                Ptr2 = Buffer2 + Align2;
+                FillPattern(Ptr1, Length, 0x30);
+                FillPattern(Ptr2, Length, 0x30);
+                Ptr1[Length] = 0x01;
+                Ptr2[Length] = 0x02;
+
+                ok(memcmp(Ptr1, Ptr2, Length) == 0,
+                   "Wrong result: alignments %Iu/%Iu, length %Iu\n", Align1, Align2, Length);
+
+                /* The first differing byte decides, compared as unsigned */
+                for (Pos = 0; Pos < Length; Pos++)
+                {
+                    Ptr1[Pos] = 0x80;
+                    Ptr2[Pos] = 0x7F;
+                    if (Pos + 1 < Length)
+                    {
+                        Ptr1[Pos + 1] = 0x00;
+                        Ptr2[Pos + 1] = 0xFF;
+                    }
+
+                    ok(memcmp(Ptr1, Ptr2, Length) > 0,
+                       "Wrong result: alignments %Iu/%Iu, length %Iu, position %Iu\n",
+                       Align1, Align2, Length, Pos);
+                    ok(memcmp(Ptr2, Ptr1, Length) < 0,
+                       "Wrong result: alignments %Iu/%Iu, length %Iu, position %Iu\n",
+                       Align1, Align2, Length, Pos);
+
+                    FillPattern(Ptr1, Length, 0x30);
+                    FillPattern(Ptr2, Length, 0x30);
+                }
+            }
+        }
+    }
+
+    FillPattern(BenchBuffer1, sizeof(BenchBuffer1), 0x50);
+    FillPattern(BenchBuffer2, sizeof(BenchBuffer2), 0x50);
+
+    StartTime = GetTickCount();
+    for (i = 0; i < BENCH_LOOPS; i++)
+        Result += memcmp(BenchBuffer1, BenchBuffer2, BENCH_SIZE);
+    trace("%lu comparisons of %u equal bytes took %lu ms\n",
+          (ULONG)BENCH_LOOPS, BENCH_SIZE, GetTickCount() - StartTime);
+    ok(Result == 0, "Wrong result %d\n", Result);
+}
@@ -0,0 +1,91 @@
+/*
+ * PROJECT:     ReactOS api tests
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     Tests and throughput measurement for memcpy
+ */
+
+#include <apitest.h>
+
+#include <string.h>
+
+#define MAX_LENGTH      (3 * sizeof(size_t))
+#define BUFFER_SIZE     (MAX_LENGTH + 2 * sizeof(size_t))
+
+#define BENCH_SIZE      4096
+#define BENCH_LOOPS     100000
+
+static unsigned char Source[BUFFER_SIZE];
+static unsigned char Dest[BUFFER_SIZE];
+static unsigned char Expected[BUFFER_SIZE];
+static unsigned char BenchSource[BENCH_SIZE + sizeof(size_t)];
+static unsigned char BenchDest[BENCH_SIZE + sizeof(size_t)];
+
+static
+void
+FillPattern(unsigned char *Buffer, size_t Size, unsigned char Seed)
+{
+    size_t i;
+
+    for (i = 0; i < Size; i++)
+        Buffer[i] = (unsigned char)(Seed + i * 7 + 1);
+}
+
+static
+void
+Test_Alignments(void)
+{
+    size_t SrcAlign, DstAlign, Length, i;
+    void *Result;
+
+    FillPattern(Source, sizeof(Source), 0x10);
+
+    for (SrcAlign = 0; SrcAlign < sizeof(size_t); SrcAlign++)
+    {
+        for (DstAlign = 0; DstAlign < sizeof(size_t); DstAlign++)
+        {
+            for (Length = 0; Length <= MAX_LENGTH; Length++)
+            {
+                FillPattern(Dest, sizeof(Dest), 0x80);
+                FillPattern(Expected, sizeof(Expected), 0x80);
+                for (i = 0; i < Length; i++)
+                    Expected[DstAlign + i] = Source[SrcAlign + i];
+
+                Result = memcpy(Dest + DstAlign, Source + SrcAlign, Length);
+                ok(Result == Dest + DstAlign, "Wrong result %p for %p\n", Result, Dest + DstAlign);
+                ok(memcmp(Dest, Expected, sizeof(Dest)) == 0,
+                   "Wrong copy: source alignment %Iu, destination alignment %Iu, length %Iu\n",
+                   SrcAlign, DstAlign, Length);
+            }
+        }
+    }
+}
+
+static
+void
+Test_Throughput(void)
+{
+    DWORD StartTime;
+    ULONG i;
+
+    FillPattern(BenchSource, sizeof(BenchSource), 0x20);
+
+    StartTime = GetTickCount();
+    for (i = 0; i < BENCH_LOOPS; i++)
+        memcpy(BenchDest, BenchSource, BENCH_SIZE);
+    trace("%lu aligned copies of %u bytes took %lu ms\n",
+          (ULONG)BENCH_LOOPS, BENCH_SIZE, GetTickCount() - StartTime);
+
+    StartTime = GetTickCount();
+    for (i = 0; i < BENCH_LOOPS; i++)
+        memcpy(BenchDest + 1, BenchSource + 1, BENCH_SIZE);
+    trace("%lu misaligned copies of %u bytes took %lu ms\n",
+          (ULONG)BENCH_LOOPS, BENCH_SIZE, GetTickCount() - StartTime);
+
+    ok(memcmp(BenchDest + 1, BenchSource + 1, BENCH_SIZE) == 0, "Wrong copy\n");
+}
+
+START_TEST(memcpy)
+{
+    Test_Alignments();
+    Test_Throughput();
+}
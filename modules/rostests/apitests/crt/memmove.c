@@ -0,0 +1,56 @@
+/*
+ * PROJECT:     ReactOS api tests
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     Tests for memmove
+ */
+
+#include <apitest.h>
+
+#include <string.h>
+
+#define MAX_LENGTH      (3 * sizeof(size_t))
+#define MAX_OFFSET      (2 * sizeof(size_t))
+#define BUFFER_SIZE     (MAX_LENGTH + MAX_OFFSET)
+
+static unsigned char Buffer[BUFFER_SIZE];
+static unsigned char Expected[BUFFER_SIZE];
+static unsigned char Temp[MAX_LENGTH];
+
+static
+void
+FillPattern(unsigned char *Buffer, size_t Size, unsigned char Seed)
+{
+    size_t i;
+
+    for (i = 0; i < Size; i++)
+        Buffer[i] = (unsigned char)(Seed + i * 7 + 1);
+}
+
+START_TEST(memmove)
+{
+    size_t SrcOffset, DstOffset, Length, i;
+    void *Result;
+
+    /* Moves within one buffer, overlapping forwards and backwards, or not at all */
+    for (SrcOffset = 0; SrcOffset <= MAX_OFFSET; SrcOffset++)
+    {
+        for (DstOffset = 0; DstOffset <= MAX_OFFSET; DstOffset++)
+        {
+            for (Length = 0; Length <= MAX_LENGTH; Length++)
+            {
+                FillPattern(Buffer, sizeof(Buffer), 0x40);
+                FillPattern(Expected, sizeof(Expected), 0x40);
+                for (i = 0; i < Length; i++)
+                    Temp[i] = Expected[SrcOffset + i];
+                for (i = 0; i < Length; i++)
+                    Expected[DstOffset + i] = Temp[i];
+
+                Result = memmove(Buffer + DstOffset, Buffer + SrcOffset, Length);
+                ok(Result == Buffer + DstOffset, "Wrong result %p for %p\n", Result, Buffer + DstOffset);
+                ok(memcmp(Buffer, Expected, sizeof(Buffer)) == 0,
+                   "Wrong move: source offset %Iu, destination offset %Iu, length %Iu\n",
+                   SrcOffset, DstOffset, Length);
+            }
+        }
+    }
+}
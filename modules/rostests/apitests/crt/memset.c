@@ -0,0 +1,63 @@
+/*
+ * PROJECT:     ReactOS api tests
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     Tests and throughput measurement for memset
+ */
+
+#include <apitest.h>
+
+#include <string.h>
+
+#define MAX_LENGTH      (3 * sizeof(size_t))
+#define BUFFER_SIZE     (MAX_LENGTH + 2 * sizeof(size_t))
+
+#define BENCH_SIZE      4096
+#define BENCH_LOOPS     100000
+
+static unsigned char Buffer[BUFFER_SIZE];
+static unsigned char Expected[BUFFER_SIZE];
+static unsigned char BenchBuffer[BENCH_SIZE + sizeof(size_t)];
+
+static
+void
+FillPattern(unsigned char *Buffer, size_t Size, unsigned char Seed)
+{
+    size_t i;
+
+    for (i = 0; i < Size; i++)
+        Buffer[i] = (unsigned char)(Seed + i * 7 + 1);
+}
+
+START_TEST(memset)
+{
+    /* Only the low byte of the value is used */
+    static const int Values[] = { 0x00, 0x5A, 0xFF, 0x1234, -1 };
+    size_t Align, Length, v, i;
+    DWORD StartTime;
+    void *Result;
+
+    for (v = 0; v < sizeof(Values) / sizeof(Values[0]); v++)
+    {
+        for (Align = 0; Align < sizeof(size_t); Align++)
+        {
+            for (Length = 0; Length <= MAX_LENGTH; Length++)
+            {
+                FillPattern(Buffer, sizeof(Buffer), 0x60);
+                FillPattern(Expected, sizeof(Expected), 0x60);
+                for (i = 0; i < Length; i++)
+                    Expected[Align + i] = (unsigned char)Values[v];
+
+                Result = memset(Buffer + Align, Values[v], Length);
+                ok(Result == Buffer + Align, "Wrong result %p for %p\n", Result, Buffer + Align);
+                ok(memcmp(Buffer, Expected, sizeof(Buffer)) == 0,
+                   "Wrong fill: value 0x%x, alignment %Iu, length %Iu\n", Values[v], Align, Length);
+            }
+        }
+    }
+
+    StartTime = GetTickCount();
+    for (i = 0; i < BENCH_LOOPS; i++)
+        memset(BenchBuffer + 1, (int)i, BENCH_SIZE);
+    trace("%lu misaligned fills of %u bytes took %lu ms\n",
+          (ULONG)BENCH_LOOPS, BENCH_SIZE, GetTickCount() - StartTime);
+}
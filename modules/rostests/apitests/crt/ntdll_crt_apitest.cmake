@@ -74,10 +74,10 @@ list(APPEND SOURCE_NTDLL
     mbstowcs.c
     mbtowc.c
 #    memchr.c
-#    memcmp.c
-    # memcpy == memmove
-#    memmove.c
-#    memset.c
+    memcmp.c
+    memcpy.c # == memmove
+    memmove.c
+    memset.c
 #    pow.c
 #    qsort.c
 #    sin.c
@@ -13,6 +13,10 @@ list(APPEND SOURCE_STATIC
     fpcontrol.c
     mbstowcs.c
     mbtowc.c
+    memcmp.c
+    memcpy.c
+    memmove.c
+    memset.c
     rand_s.c
     sprintf.c
     strcpy.c
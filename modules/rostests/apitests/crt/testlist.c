@@ -32,6 +32,10 @@ extern void func__vsnprintf(void);
 extern void func__vsnwprintf(void);
 extern void func_mbstowcs(void);
 extern void func_mbtowc(void);
+extern void func_memcmp(void);
+extern void func_memcpy(void);
+extern void func_memmove(void);
+extern void func_memset(void);
 extern void func_rand_s(void);
 extern void func_sprintf(void);
 extern void func_strcpy(void);
@@ -56,6 +60,10 @@ const struct test winetest_testlist[] =
     { "_vsnwprintf", func__vsnwprintf },
     { "mbstowcs", func_mbstowcs },
     { "mbtowc", func_mbtowc },
+    { "memcmp", func_memcmp },
+    { "memcpy", func_memcpy },
+    { "memmove", func_memmove },
+    { "memset", func_memset },
     { "_snprintf", func__snprintf },
     { "_snwprintf", func__snwprintf },
     { "sprintf", func_sprintf },
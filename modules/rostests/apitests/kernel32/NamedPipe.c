@@ -0,0 +1,141 @@
+/*
+ * PROJECT:     ReactOS api tests
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     Tests and throughput measurement for named pipe reads and writes
+ */
+
+#include "precomp.h"
+
+#define PIPE_NAME       L"\\\\.\\pipe\\kernel32_apitest_NamedPipe"
+#define TOTAL_BYTES     (64 * 1024 * 1024)
+
+typedef struct _PIPE_READER
+{
+    HANDLE hPipe;
+    DWORD BlockSize;
+    DWORD BytesRead;
+    DWORD BadOffset;
+} PIPE_READER, *PPIPE_READER;
+
+static UCHAR
+PatternByte(DWORD Offset)
+{
+    return (UCHAR)(Offset % 251);
+}
+
+static DWORD WINAPI
+ReaderThread(LPVOID Param)
+{
+    PPIPE_READER Reader = Param;
+    PUCHAR Buffer;
+    DWORD Read, i;
+
+    Buffer = HeapAlloc(GetProcessHeap(), 0, Reader->BlockSize);
+    if (!Buffer)
+        return 1;
+
+    /* Most of these reads pend until the writer fills them */
+    while (Reader->BytesRead < TOTAL_BYTES)
+    {
+        if (!ReadFile(Reader->hPipe, Buffer, Reader->BlockSize, &Read, NULL) || !Read)
+            break;
+
+        for (i = 0; i < Read; i++)
+        {
+            if (Buffer[i] != PatternByte(Reader->BytesRead + i) && Reader->BadOffset == MAXDWORD)
+                Reader->BadOffset = Reader->BytesRead + i;
+        }
+        Reader->BytesRead += Read;
+    }
+
+    HeapFree(GetProcessHeap(), 0, Buffer);
+    return 0;
+}
+
+static VOID
+TestThroughput(DWORD BlockSize)
+{
+    PIPE_READER Reader;
+    HANDLE hServer, hClient, hThread;
+    PUCHAR Buffer;
+    DWORD Written, Offset, i;
+    DWORD StartTime;
+
+    hServer = CreateNamedPipeW(PIPE_NAME,
+                               PIPE_ACCESS_INBOUND,
+                               PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT,
+                               1,
+                               0,
+                               BlockSize,
+                               0,
+                               NULL);
+    ok(hServer != INVALID_HANDLE_VALUE, "CreateNamedPipeW failed: %lu\n", GetLastError());
+    if (hServer == INVALID_HANDLE_VALUE)
+        return;
+
+    hClient = CreateFileW(PIPE_NAME, GENERIC_WRITE, 0, NULL, OPEN_EXISTING, 0, NULL);
+    ok(hClient != INVALID_HANDLE_VALUE, "CreateFileW failed: %lu\n", GetLastError());
+    if (hClient == INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(hServer);
+        return;
+    }
+
+    Buffer = HeapAlloc(GetProcessHeap(), 0, BlockSize);
+    ok(Buffer != NULL, "HeapAlloc failed\n");
+    if (!Buffer)
+    {
+        CloseHandle(hClient);
+        CloseHandle(hServer);
+        return;
+    }
+
+    Reader.hPipe = hServer;
+    Reader.BlockSize = BlockSize;
+    Reader.BytesRead = 0;
+    Reader.BadOffset = MAXDWORD;
+
+    StartTime = GetTickCount();
+
+    hThread = CreateThread(NULL, 0, ReaderThread, &Reader, 0, NULL);
+    ok(hThread != NULL, "CreateThread failed: %lu\n", GetLastError());
+    if (hThread)
+    {
+        for (Offset = 0; Offset < TOTAL_BYTES; Offset += BlockSize)
+        {
+            for (i = 0; i < BlockSize; i++)
+                Buffer[i] = PatternByte(Offset + i);
+
+            if (!WriteFile(hClient, Buffer, BlockSize, &Written, NULL) || Written != BlockSize)
+            {
+                ok(0, "WriteFile failed at offset %lu: %lu\n", Offset, GetLastError());
+                break;
+            }
+        }
+
+        CloseHandle(hClient);
+        hClient = NULL;
+        WaitForSingleObject(hThread, INFINITE);
+        CloseHandle(hThread);
+
+        trace("%lu bytes in %lu byte blocks took %lu ms\n",
+              (DWORD)TOTAL_BYTES, BlockSize, GetTickCount() - StartTime);
+
+        ok(Reader.BytesRead == TOTAL_BYTES, "Read %lu bytes instead of %lu\n",
+           Reader.BytesRead, (DWORD)TOTAL_BYTES);
+        ok(Reader.BadOffset == MAXDWORD, "Wrong data at offset %lu\n", Reader.BadOffset);
+    }
+
+    HeapFree(GetProcessHeap(), 0, Buffer);
+    if (hClient) CloseHandle(hClient);
+    CloseHandle(hServer);
+}
+
+START_TEST(NamedPipe)
+{
+    /* The last size is above the limit for copying straight into the reader */
+    TestThroughput(512);
+    TestThroughput(4096);
+    TestThroughput(64 * 1024);
+    TestThroughput(256 * 1024);
+}
@@ -0,0 +1,118 @@
+/*
+ * PROJECT:     ReactOS api tests
+ * LICENSE:     GPL-2.0-or-later (https://spdx.org/licenses/GPL-2.0-or-later)
+ * PURPOSE:     Tests and throughput measurement for ScrollConsoleScreenBuffer
+ */
+
+#include "precomp.h"
+
+#define BUFFER_WIDTH    80
+#define BUFFER_HEIGHT   50
+#define SCROLL_LOOPS    2000
+
+static VOID
+FillLines(HANDLE hConOut)
+{
+    WCHAR Line[BUFFER_WIDTH];
+    COORD Coord;
+    DWORD Written;
+    SHORT Y, X;
+
+    for (Y = 0; Y < BUFFER_HEIGHT; ++Y)
+    {
+        for (X = 0; X < BUFFER_WIDTH; ++X)
+            Line[X] = L'0' + (Y % 40);
+
+        Coord.X = 0;
+        Coord.Y = Y;
+        WriteConsoleOutputCharacterW(hConOut, Line, BUFFER_WIDTH, Coord, &Written);
+        ok_long(Written, BUFFER_WIDTH);
+    }
+}
+
+static WCHAR
+GetCellChar(HANDLE hConOut, SHORT X, SHORT Y)
+{
+    WCHAR Char = 0;
+    COORD Coord = {X, Y};
+    DWORD Read;
+
+    ReadConsoleOutputCharacterW(hConOut, &Char, 1, Coord, &Read);
+    return Char;
+}
+
+static VOID
+TestScroll(HANDLE hConOut, SHORT Lines)
+{
+    SMALL_RECT ScrollRect = {0, Lines, BUFFER_WIDTH - 1, BUFFER_HEIGHT - 1};
+    COORD Origin = {0, 0};
+    CHAR_INFO Fill;
+    BOOL Success;
+    SHORT Y;
+
+    FillLines(hConOut);
+
+    Fill.Char.UnicodeChar = L'#';
+    Fill.Attributes = FOREGROUND_GREEN;
+    Success = ScrollConsoleScreenBufferW(hConOut, &ScrollRect, NULL, Origin, &Fill);
+    ok(Success, "ScrollConsoleScreenBufferW failed, error %lu\n", GetLastError());
+
+    /* The lines moved up... */
+    for (Y = 0; Y < BUFFER_HEIGHT - Lines; ++Y)
+    {
+        ok(GetCellChar(hConOut, 0, Y) == L'0' + ((Y + Lines) % 40),
+           "Scroll by %d: line %d has 0x%04x\n", Lines, Y, GetCellChar(hConOut, 0, Y));
+        ok(GetCellChar(hConOut, BUFFER_WIDTH - 1, Y) == L'0' + ((Y + Lines) % 40),
+           "Scroll by %d: end of line %d has 0x%04x\n", Lines, Y, GetCellChar(hConOut, BUFFER_WIDTH - 1, Y));
+    }
+
+    /* ... and the uncovered part of the source was filled, and nothing else */
+    for (; Y < BUFFER_HEIGHT; ++Y)
+    {
+        WCHAR Expected = (Y >= Lines) ? L'#' : L'0' + (Y % 40);
+        ok(GetCellChar(hConOut, 0, Y) == Expected,
+           "Scroll by %d: line %d has 0x%04x, expected 0x%04x\n", Lines, Y, GetCellChar(hConOut, 0, Y), Expected);
+    }
+}
+
+START_TEST(ScrollConsoleScreenBuffer)
+{
+    HANDLE hConOut;
+    COORD Size = {BUFFER_WIDTH, BUFFER_HEIGHT};
+    SMALL_RECT ScrollRect = {0, 1, BUFFER_WIDTH - 1, BUFFER_HEIGHT - 1};
+    COORD Origin = {0, 0};
+    CHAR_INFO Fill;
+    DWORD StartTime, i;
+
+    hConOut = CreateConsoleScreenBuffer(GENERIC_READ | GENERIC_WRITE,
+                                        FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                        NULL, CONSOLE_TEXTMODE_BUFFER, NULL);
+    if (hConOut == INVALID_HANDLE_VALUE)
+    {
+        skip("CreateConsoleScreenBuffer failed, error %lu\n", GetLastError());
+        return;
+    }
+
+    if (!SetConsoleScreenBufferSize(hConOut, Size))
+    {
+        skip("SetConsoleScreenBufferSize failed, error %lu\n", GetLastError());
+        CloseHandle(hConOut);
+        return;
+    }
+
+    /* Scrolling the whole buffer by a few lines, or by more than half of it */
+    TestScroll(hConOut, 1);
+    TestScroll(hConOut, 3);
+    TestScroll(hConOut, BUFFER_HEIGHT / 2);
+    TestScroll(hConOut, BUFFER_HEIGHT - 5);
+
+    /* Measure the line scrolling throughput, as done by fast-scrolling tools */
+    Fill.Char.UnicodeChar = L' ';
+    Fill.Attributes = FOREGROUND_GREEN;
+    StartTime = GetTickCount();
+    for (i = 0; i < SCROLL_LOOPS; ++i)
+        ScrollConsoleScreenBufferW(hConOut, &ScrollRect, NULL, Origin, &Fill);
+    trace("%d full-buffer scrolls took %lu ms\n", SCROLL_LOOPS, GetTickCount() - StartTime);
+
+    CloseHandle(hConOut);
+}
@@ -1314,6 +1314,73 @@ static void test_bitmap_scaler(void)
     IWICBitmap_Release(bitmap);
 }
 
+#ifdef __REACTOS__
+static void check_scaled_bitmap(const BYTE *src, UINT src_width, UINT src_height,
+    UINT width, UINT height, WICBitmapInterpolationMode mode, const BYTE *expected, int line)
+{
+    IWICBitmapScaler *scaler;
+    IWICBitmap *bitmap;
+    BYTE buf[16];
+    UINT i;
+    HRESULT hr;
+
+    hr = IWICImagingFactory_CreateBitmapFromMemory(factory, src_width, src_height, &GUID_WICPixelFormat8bppGray,
+        src_width, src_width * src_height, (BYTE *)src, &bitmap);
+    ok_(__FILE__, line)(hr == S_OK, "Failed to create a bitmap, hr %#x.\n", hr);
+
+    hr = IWICImagingFactory_CreateBitmapScaler(factory, &scaler);
+    ok_(__FILE__, line)(hr == S_OK, "Failed to create bitmap scaler, hr %#x.\n", hr);
+
+    hr = IWICBitmapScaler_Initialize(scaler, (IWICBitmapSource *)bitmap, width, height, mode);
+    ok_(__FILE__, line)(hr == S_OK, "Failed to initialize bitmap scaler, hr %#x.\n", hr);
+
+    memset(buf, 0xcc, sizeof(buf));
+    hr = IWICBitmapScaler_CopyPixels(scaler, NULL, width, sizeof(buf), buf);
+    ok_(__FILE__, line)(hr == S_OK, "Failed to copy pixels, hr %#x.\n", hr);
+
+    for (i = 0; i < width * height; i++)
+        ok_(__FILE__, line)(abs(buf[i] - expected[i]) <= 1, "%u: got %u, expected %u.\n", i, buf[i], expected[i]);
+
+    IWICBitmapScaler_Release(scaler);
+    IWICBitmap_Release(bitmap);
+}
+
+static void test_bitmap_scaler_interpolation(void)
+{
+    static const BYTE row3[] = { 0, 90, 180 };
+    static const BYTE row2[] = { 0, 200 };
+    static const BYTE row4[] = { 0, 100, 200, 40 };
+    static const BYTE box4x2[] = { 10, 20, 30, 40,
+                                   50, 60, 70, 80 };
+    static const BYTE box3x3[] = {   0,  90, 180,
+                                     0,  90, 180,
+                                   255, 255, 255 };
+    static const BYTE diag2x2[] = {   0, 200,
+                                    200,   0 };
+    /* Partially covered source pixels only count for the part covered */
+    static const BYTE fant_row3to2[] = { 30, 150 };
+    static const BYTE fant_box4x2to2x1[] = { 35, 55 };
+    static const BYTE fant_box3x3to2x2[] = {  30, 150,
+                                             180, 220 };
+    /* Enlarging interpolates between the pixel centers, in every mode but nearest neighbor */
+    static const BYTE row2to4[] = { 0, 50, 150, 200 };
+    static const BYTE linear_row4to2[] = { 50, 120 };
+    static const BYTE linear_diag2x2to4x4[] = {   0,  50, 150, 200,
+                                                 50,  75, 125, 150,
+                                                150, 125,  75,  50,
+                                                200, 150,  50,   0 };
+
+    check_scaled_bitmap(row3, 3, 1, 2, 1, WICBitmapInterpolationModeFant, fant_row3to2, __LINE__);
+    check_scaled_bitmap(box4x2, 4, 2, 2, 1, WICBitmapInterpolationModeFant, fant_box4x2to2x1, __LINE__);
+    check_scaled_bitmap(box3x3, 3, 3, 2, 2, WICBitmapInterpolationModeFant, fant_box3x3to2x2, __LINE__);
+    check_scaled_bitmap(row2, 2, 1, 4, 1, WICBitmapInterpolationModeFant, row2to4, __LINE__);
+
+    check_scaled_bitmap(row4, 4, 1, 2, 1, WICBitmapInterpolationModeLinear, linear_row4to2, __LINE__);
+    check_scaled_bitmap(row2, 2, 1, 4, 1, WICBitmapInterpolationModeLinear, row2to4, __LINE__);
+    check_scaled_bitmap(diag2x2, 2, 2, 4, 4, WICBitmapInterpolationModeLinear, linear_diag2x2to4x4, __LINE__);
+}
+#endif
+
 static LONG obj_refcount(void *obj)
 {
     IUnknown_AddRef((IUnknown *)obj);
@@ -1484,6 +1551,9 @@ START_TEST(bitmap)
     test_CreateBitmapFromHBITMAP();
     test_clipper();
     test_bitmap_scaler();
+#ifdef __REACTOS__
+    test_bitmap_scaler_interpolation();
+#endif
 
     IWICImagingFactory_Release(factory);
 
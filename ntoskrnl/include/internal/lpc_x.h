@@ -101,13 +101,14 @@ LpcpAllocateFromPortZone(VOID)
 {
     PLPCP_MESSAGE Message;
 
-    /* Allocate a message from the port zone while holding the lock */
-    KeAcquireGuardedMutex(&LpcpLock);
+    /*
+     * Allocate a message from the port zone. The lookaside list is
+     * interlocked on its own, so there is no need to hold the LPC lock.
+     */
     Message = (PLPCP_MESSAGE)ExAllocateFromPagedLookasideList(&LpcpMessagesLookaside);
     if (!Message)
     {
         /* Fail, and let caller cleanup */
-        KeReleaseGuardedMutex(&LpcpLock);
         return NULL;
     }
 
@@ -116,8 +117,6 @@ LpcpAllocateFromPortZone(VOID)
     Message->RepliedToThread = NULL;
     Message->Request.u2.ZeroInit = 0;
 
-    /* Release the lock */
-    KeReleaseGuardedMutex(&LpcpLock);
     return Message;
 }
 
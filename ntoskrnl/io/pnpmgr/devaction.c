@@ -41,6 +41,9 @@ extern BOOLEAN PnPBootDriversInitialized;
 #define MAX_SEPARATORS_INSTANCEID  0
 #define MAX_SEPARATORS_DEVICEID    1
 
+/* Maximum number of IRP_MN_START_DEVICE requests in progress at the same time */
+#define MAX_PARALLEL_DEVICE_STARTS 4
+
 /* DATA **********************************************************************/
 
 LIST_ENTRY IopDeviceActionRequestList;
@@ -84,6 +87,12 @@ typedef struct _ATTACH_FILTER_DRIVERS_CONTEXT
     PLIST_ENTRY DriversListHead;
 } ATTACH_FILTER_DRIVERS_CONTEXT, *PATTACH_FILTER_DRIVERS_CONTEXT;
 
+typedef struct _DEVICE_START_CONTEXT
+{
+    PDEVICE_NODE DeviceNode;
+    PKSEMAPHORE StartSlots;
+} DEVICE_START_CONTEXT, *PDEVICE_START_CONTEXT;
+
 /* FUNCTIONS *****************************************************************/
 
 PDEVICE_OBJECT
@@ -2307,6 +2316,119 @@ PiFakeResourceRebalance(
     DeviceNode->Flags &= ~DNF_RESOURCE_REQUIREMENTS_CHANGED;
 }
 
+static
+VOID
+NTAPI
+PiStartDeviceThread(
+    _In_ PVOID Context)
+{
+    PDEVICE_START_CONTEXT startContext = Context;
+    PDEVICE_NODE deviceNode = startContext->DeviceNode;
+    PKSEMAPHORE startSlots = startContext->StartSlots;
+
+    ExFreePoolWithTag(startContext, TAG_IO);
+
+    PiIrpStartDevice(deviceNode);
+    ObDereferenceObject(deviceNode->PhysicalDeviceObject);
+
+    // the semaphore lives on the stack of PiDevNodeStateMachine, don't touch it afterwards
+    KeReleaseSemaphore(startSlots, IO_NO_INCREMENT, 1, FALSE);
+
+    PsTerminateSystemThread(STATUS_SUCCESS);
+}
+
+/**
+ * @brief      Send IRP_MN_START_DEVICE to a device from a separate thread.
+ *
+ * The device node is put into DeviceNodeStartPending state, and it is moved
+ * further by the next pass of PiDevNodeStateMachine, once all the start requests
+ * of the current pass are completed.
+ *
+ * @param[in]  DeviceNode  The device node, in DeviceNodeResourcesAssigned state
+ * @param[in]  StartSlots  Semaphore limiting the number of simultaneous start requests
+ *
+ * @return     TRUE if the request was queued, FALSE if the caller has to do it by itself
+ */
+static
+BOOLEAN
+PiStartDeviceAsync(
+    _In_ PDEVICE_NODE DeviceNode,
+    _In_ PKSEMAPHORE StartSlots)
+{
+    PDEVICE_START_CONTEXT startContext;
+    HANDLE threadHandle;
+    NTSTATUS status;
+
+    PAGED_CODE();
+
+    // the children of the node would be processed while it is being started
+    if (DeviceNode->Child != NULL)
+        return FALSE;
+
+    startContext = ExAllocatePoolWithTag(NonPagedPool, sizeof(*startContext), TAG_IO);
+    if (!startContext)
+        return FALSE;
+
+    startContext->DeviceNode = DeviceNode;
+    startContext->StartSlots = StartSlots;
+
+    KeWaitForSingleObject(StartSlots, Executive, KernelMode, FALSE, NULL);
+
+    PiSetDevNodeState(DeviceNode, DeviceNodeStartPending);
+    ObReferenceObject(DeviceNode->PhysicalDeviceObject);
+
+    status = PsCreateSystemThread(&threadHandle,
+                                  THREAD_ALL_ACCESS,
+                                  NULL,
+                                  NULL,
+                                  NULL,
+                                  PiStartDeviceThread,
+                                  startContext);
+    if (!NT_SUCCESS(status))
+    {
+        DPRINT1("PsCreateSystemThread() failed for %wZ, status %x\n",
+                &DeviceNode->InstancePath, status);
+
+        ObDereferenceObject(DeviceNode->PhysicalDeviceObject);
+        ExFreePoolWithTag(startContext, TAG_IO);
+        KeReleaseSemaphore(StartSlots, IO_NO_INCREMENT, 1, FALSE);
+
+        // the node is already in DeviceNodeStartPending state, send the request from here
+        PiIrpStartDevice(DeviceNode);
+        return TRUE;
+    }
+
+    ZwClose(threadHandle);
+    return TRUE;
+}
+
+/**
+ * @brief      Wait until all start requests sent by PiStartDeviceAsync are completed.
+ */
+static
+VOID
+PiWaitForDeviceStarts(
+    _In_ PKSEMAPHORE StartSlots)
+{
+    ULONG i;
+
+    for (i = 0; i < MAX_PARALLEL_DEVICE_STARTS; i++)
+    {
+        KeWaitForSingleObject(StartSlots, Executive, KernelMode, FALSE, NULL);
+    }
+
+    KeReleaseSemaphore(StartSlots, IO_NO_INCREMENT, MAX_PARALLEL_DEVICE_STARTS, FALSE);
+}
+
+/*
+ * The device tree is processed in passes. Everything is done sequentially,
+ * except IRP_MN_START_DEVICE requests which, for devices without children yet,
+ * are sent from separate threads (up to MAX_PARALLEL_DEVICE_STARTS). Such
+ * devices are not processed further during the pass, so their children get
+ * enumerated and started (in parallel again) by the next pass, which is run
+ * once all start requests have completed. Resource assignment and AddDevice
+ * calls stay serialized on the device action worker.
+ */
 static
 VOID
 PiDevNodeStateMachine(
@@ -2314,8 +2436,16 @@ PiDevNodeStateMachine(
 {
     NTSTATUS status;
     BOOLEAN doProcessAgain;
-    PDEVICE_NODE currentNode = RootNode;
+    BOOLEAN startsPending;
+    PDEVICE_NODE currentNode;
     PDEVICE_OBJECT referencedObject;
+    KSEMAPHORE startSlots;
+
+    KeInitializeSemaphore(&startSlots, MAX_PARALLEL_DEVICE_STARTS, MAX_PARALLEL_DEVICE_STARTS);
+
+pass:
+    startsPending = FALSE;
+    currentNode = RootNode;
 
     do
     {
@@ -2354,14 +2484,23 @@ PiDevNodeStateMachine(
                 break;
             case DeviceNodeResourcesAssigned:
                 DPRINT("DeviceNodeResourcesAssigned %wZ\n", &currentNode->InstancePath);
-                // send IRP_MN_START_DEVICE
-                PiIrpStartDevice(currentNode);
+                // send IRP_MN_START_DEVICE, asynchronously if possible
+                if (PiStartDeviceAsync(currentNode, &startSlots))
+                {
+                    startsPending = TRUE;
+                    break;
+                }
 
-                // skip DeviceNodeStartPending, it is probably used for an async IRP_MN_START_DEVICE
+                PiIrpStartDevice(currentNode);
                 PiSetDevNodeState(currentNode, DeviceNodeStartCompletion);
                 doProcessAgain = TRUE;
                 break;
-            case DeviceNodeStartPending: // skipped on XP/2003
+            case DeviceNodeStartPending:
+                // we're here in the pass following the one which sent IRP_MN_START_DEVICE,
+                // after the request was completed
+                DPRINT("DeviceNodeStartPending %wZ\n", &currentNode->InstancePath);
+                PiSetDevNodeState(currentNode, DeviceNodeStartCompletion);
+                doProcessAgain = TRUE;
                 break;
             case DeviceNodeStartCompletion:
                 DPRINT("DeviceNodeStartCompletion %wZ\n", &currentNode->InstancePath);
@@ -2503,6 +2642,12 @@ skipEnum:
         }
         ObDereferenceObject(referencedObject);
     } while (doProcessAgain || currentNode != RootNode);
+
+    if (startsPending)
+    {
+        PiWaitForDeviceStarts(&startSlots);
+        goto pass;
+    }
 }
 
 #ifdef DBG
@@ -273,23 +273,7 @@ NtReplyPort(IN HANDLE PortHandle,
         return STATUS_NO_MEMORY;
     }
 
-    /* Keep the lock acquired */
-    KeAcquireGuardedMutex(&LpcpLock);
-
-    /* Make sure this is the reply the thread is waiting for */
-    if ((WakeupThread->LpcReplyMessageId != CapturedReplyMessage.MessageId) ||
-        ((LpcpGetMessageFromThread(WakeupThread)) &&
-        (LpcpGetMessageType(&LpcpGetMessageFromThread(WakeupThread)-> Request)
-            != LPC_REQUEST)))
-    {
-        /* It isn't, fail */
-        LpcpFreeToPortZone(Message, LPCP_LOCK_HELD | LPCP_LOCK_RELEASE);
-        ObDereferenceObject(WakeupThread);
-        ObDereferenceObject(Port);
-        return STATUS_REPLY_MESSAGE_MISMATCH;
-    }
-
-    /* Copy the message */
+    /* Copy the message before taking the lock, it is not visible to anyone yet */
     _SEH2_TRY
     {
         LpcpMoveMessage(&Message->Request,
@@ -301,13 +285,29 @@ NtReplyPort(IN HANDLE PortHandle,
     _SEH2_EXCEPT(EXCEPTION_EXECUTE_HANDLER)
     {
         /* Cleanup and return the exception code */
-        LpcpFreeToPortZone(Message, LPCP_LOCK_HELD | LPCP_LOCK_RELEASE);
+        LpcpFreeToPortZone(Message, 0);
         ObDereferenceObject(WakeupThread);
         ObDereferenceObject(Port);
         _SEH2_YIELD(return _SEH2_GetExceptionCode());
     }
     _SEH2_END;
 
+    /* Now acquire the lock */
+    KeAcquireGuardedMutex(&LpcpLock);
+
+    /* Make sure this is the reply the thread is waiting for */
+    if ((WakeupThread->LpcReplyMessageId != CapturedReplyMessage.MessageId) ||
+        ((LpcpGetMessageFromThread(WakeupThread)) &&
+        (LpcpGetMessageType(&LpcpGetMessageFromThread(WakeupThread)-> Request)
+            != LPC_REQUEST)))
+    {
+        /* It isn't, fail */
+        LpcpFreeToPortZone(Message, LPCP_LOCK_HELD | LPCP_LOCK_RELEASE);
+        ObDereferenceObject(WakeupThread);
+        ObDereferenceObject(Port);
+        return STATUS_REPLY_MESSAGE_MISMATCH;
+    }
+
     /* Reference the thread while we use it */
     ObReferenceObject(WakeupThread);
     Message->RepliedToThread = WakeupThread;
@@ -517,24 +517,7 @@ NtReplyWaitReceivePortEx(IN HANDLE PortHandle,
             return STATUS_NO_MEMORY;
         }
 
-        /* Keep the lock acquired */
-        KeAcquireGuardedMutex(&LpcpLock);
-
-        /* Make sure this is the reply the thread is waiting for */
-        if ((WakeupThread->LpcReplyMessageId != CapturedReplyMessage.MessageId) ||
-            ((LpcpGetMessageFromThread(WakeupThread)) &&
-             (LpcpGetMessageType(&LpcpGetMessageFromThread(WakeupThread)->Request)
-                != LPC_REQUEST)))
-        {
-            /* It isn't, fail */
-            LpcpFreeToPortZone(Message, LPCP_LOCK_HELD | LPCP_LOCK_RELEASE);
-            if (ConnectionPort) ObDereferenceObject(ConnectionPort);
-            ObDereferenceObject(WakeupThread);
-            ObDereferenceObject(Port);
-            return STATUS_REPLY_MESSAGE_MISMATCH;
-        }
-
-        /* Copy the message */
+        /* Copy the message before taking the lock, it is not visible to anyone yet */
         _SEH2_TRY
         {
             LpcpMoveMessage(&Message->Request,
@@ -546,7 +529,7 @@ NtReplyWaitReceivePortEx(IN HANDLE PortHandle,
         _SEH2_EXCEPT(EXCEPTION_EXECUTE_HANDLER)
         {
             /* Cleanup and return the exception code */
-            LpcpFreeToPortZone(Message, LPCP_LOCK_HELD | LPCP_LOCK_RELEASE);
+            LpcpFreeToPortZone(Message, 0);
             if (ConnectionPort) ObDereferenceObject(ConnectionPort);
             ObDereferenceObject(WakeupThread);
             ObDereferenceObject(Port);
@@ -554,6 +537,23 @@ NtReplyWaitReceivePortEx(IN HANDLE PortHandle,
         }
         _SEH2_END;
 
+        /* Now acquire the lock */
+        KeAcquireGuardedMutex(&LpcpLock);
+
+        /* Make sure this is the reply the thread is waiting for */
+        if ((WakeupThread->LpcReplyMessageId != CapturedReplyMessage.MessageId) ||
+            ((LpcpGetMessageFromThread(WakeupThread)) &&
+             (LpcpGetMessageType(&LpcpGetMessageFromThread(WakeupThread)->Request)
+                != LPC_REQUEST)))
+        {
+            /* It isn't, fail */
+            LpcpFreeToPortZone(Message, LPCP_LOCK_HELD | LPCP_LOCK_RELEASE);
+            if (ConnectionPort) ObDereferenceObject(ConnectionPort);
+            ObDereferenceObject(WakeupThread);
+            ObDereferenceObject(Port);
+            return STATUS_REPLY_MESSAGE_MISMATCH;
+        }
+
         /* Reference the thread while we use it */
         ObReferenceObject(WakeupThread);
         Message->RepliedToThread = WakeupThread;
@@ -641,6 +641,45 @@ NtReplyWaitReceivePortEx(IN HANDLE PortHandle,
     Thread->LpcReceivedMessageId = Message->Request.MessageId;
     Thread->LpcReceivedMsgIdValid = TRUE;
 
+    /* Check if this is a plain message or event without data information */
+    if ((LpcpGetMessageType(&Message->Request) != LPC_CONNECTION_REQUEST) &&
+        (LpcpGetMessageType(&Message->Request) != LPC_REPLY) &&
+        !(Message->Request.u2.s2.DataInfoOffset))
+    {
+        /*
+         * Nobody else can reach it now that it is off the queue, so
+         * don't hold the LPC lock while copying it to the caller
+         */
+        KeReleaseGuardedMutex(&LpcpLock);
+
+        LPCTRACE(LPC_REPLY_DEBUG,
+                 "Non-Reply Messages: %p/%p\n",
+                 &Message->Request,
+                 (&Message->Request) + 1);
+
+        _SEH2_TRY
+        {
+            /* Copy it */
+            LpcpMoveMessage(ReceiveMessage,
+                            &Message->Request,
+                            (&Message->Request) + 1,
+                            0,
+                            NULL);
+
+            /* Return its context */
+            if (PortContext) *PortContext = Message->PortContext;
+        }
+        _SEH2_EXCEPT(EXCEPTION_EXECUTE_HANDLER)
+        {
+            Status = _SEH2_GetExceptionCode();
+        }
+        _SEH2_END;
+
+        /* Free it */
+        LpcpFreeToPortZone(Message, 0);
+        goto Cleanup;
+    }
+
     _SEH2_TRY
     {
         /* Check if this was a connection request */
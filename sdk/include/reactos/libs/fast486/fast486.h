@@ -107,14 +107,20 @@
 #define FAST486_PAGE_SIZE 4096
 #define FAST486_CACHE_SIZE 32
 
+/* Suggested number of code cache lines for hosts calling Fast486SetCodeCache */
+#define FAST486_CACHE_LINES 256
+
 /*
  * These are condiciones sine quibus non that should be respected, because
  * otherwise when fetching DWORDs you would read extra garbage bytes
- * (by reading outside of the prefetch buffer). The prefetch cache must
- * also not cross a page boundary.
+ * (by reading outside of the prefetch buffer). The prefetch cache lines are
+ * aligned on their size, which must be a power of two, so that they never
+ * cross a page boundary.
  */
 C_ASSERT((FAST486_CACHE_SIZE >= sizeof(ULONG))
-         && (FAST486_CACHE_SIZE <= FAST486_PAGE_SIZE));
+         && (FAST486_CACHE_SIZE <= FAST486_PAGE_SIZE)
+         && ((FAST486_CACHE_SIZE & (FAST486_CACHE_SIZE - 1)) == 0)
+         && ((FAST486_CACHE_LINES & (FAST486_CACHE_LINES - 1)) == 0));
 
 struct _FAST486_STATE;
 typedef struct _FAST486_STATE FAST486_STATE, *PFAST486_STATE;
@@ -511,6 +517,13 @@ typedef union _FAST486_FPU_CONTROL_REG
     };
 } FAST486_FPU_CONTROL_REG, *PFAST486_FPU_CONTROL_REG;
 
+typedef struct _FAST486_CACHE_LINE
+{
+    ULONG Address;
+    ULONG Generation;
+    UCHAR Data[FAST486_CACHE_SIZE];
+} FAST486_CACHE_LINE, *PFAST486_CACHE_LINE;
+
 struct _FAST486_STATE
 {
     FAST486_MEM_READ_PROC MemReadCallback;
@@ -539,10 +552,13 @@ struct _FAST486_STATE
     BOOLEAN DoNotInterrupt;
     PULONG Tlb;
     BOOLEAN TlbEmpty;
+    PUCHAR *MemoryMap;
+    ULONG MemoryMapPages;
 #ifndef FAST486_NO_PREFETCH
-    BOOLEAN PrefetchValid;
-    ULONG PrefetchAddress;
-    UCHAR PrefetchCache[FAST486_CACHE_SIZE];
+    ULONG CacheGeneration;
+    PFAST486_CACHE_LINE CodeCache;
+    ULONG CodeCacheMask;
+    FAST486_CACHE_LINE PrefetchLine;
 #endif
 #ifndef FAST486_NO_FPU
     FAST486_FPU_DATA_REG FpuRegisters[FAST486_NUM_FPU_REGS];
@@ -619,6 +635,22 @@ VOID
 NTAPI
 Fast486Rewind(PFAST486_STATE State);
 
+VOID
+NTAPI
+Fast486SetMemoryMap(PFAST486_STATE State, PUCHAR *MemoryMap, ULONG NumPages);
+
+VOID
+NTAPI
+Fast486SetCodeCache(PFAST486_STATE State, PFAST486_CACHE_LINE CodeCache, ULONG NumLines);
+
+VOID
+NTAPI
+Fast486FlushCache(PFAST486_STATE State);
+
+VOID
+NTAPI
+Fast486InvalidateCache(PFAST486_STATE State, ULONG Address, ULONG Size);
+
 #endif // _FAST486_H_
 
 /* EOF */
@@ -8,8 +8,27 @@
 
 int __cdecl memcmp(const void *s1, const void *s2, size_t n)
 {
+    const unsigned char *p1 = s1, *p2 = s2;
+
+    /* Skip the leading identical words when both buffers share the same alignment */
+    if ((n >= 2 * sizeof(size_t)) &&
+        ((((size_t)p1 ^ (size_t)p2) & (sizeof(size_t) - 1)) == 0))
+    {
+        while ((size_t)p1 & (sizeof(size_t) - 1))
+        {
+            if (*p1 != *p2)
+                return (*p1 - *p2);
+            p1++, p2++, n--;
+        }
+        while ((n >= sizeof(size_t)) && (*(const size_t *)p1 == *(const size_t *)p2))
+        {
+            p1 += sizeof(size_t);
+            p2 += sizeof(size_t);
+            n -= sizeof(size_t);
+        }
+    }
+
     if (n != 0) {
-        const unsigned char *p1 = s1, *p2 = s2;
         do {
             if (*p1++ != *p2++)
                 return (*--p1 - *--p2);
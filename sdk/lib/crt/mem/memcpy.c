@@ -7,33 +7,64 @@
 /* NOTE: This code is a duplicate of memmove implementation! */
 void* __cdecl memcpy(void* dest, const void* src, size_t count)
 {
-    char *char_dest = (char *)dest;
-    char *char_src = (char *)src;
+    unsigned char *char_dest = (unsigned char *)dest;
+    const unsigned char *char_src = (const unsigned char *)src;
 
     if ((char_dest <= char_src) || (char_dest >= (char_src+count)))
     {
-        /*  non-overlapping buffers */
-        while(count > 0)
-	{
-            *char_dest = *char_src;
-            char_dest++;
-            char_src++;
+        /* non-overlapping buffers, or copying downwards: go forward */
+        if ((count >= 2 * sizeof(size_t)) &&
+            ((((size_t)char_dest ^ (size_t)char_src) & (sizeof(size_t) - 1)) == 0))
+        {
+            /* Both buffers share the same alignment: copy whole words */
+            while ((size_t)char_dest & (sizeof(size_t) - 1))
+            {
+                *char_dest++ = *char_src++;
+                count--;
+            }
+            while (count >= sizeof(size_t))
+            {
+                *(size_t *)char_dest = *(const size_t *)char_src;
+                char_dest += sizeof(size_t);
+                char_src += sizeof(size_t);
+                count -= sizeof(size_t);
+            }
+        }
+
+        while (count > 0)
+        {
+            *char_dest++ = *char_src++;
             count--;
-	}
+        }
     }
     else
     {
-        /* overlaping buffers */
-        char_dest = (char *)dest + count - 1;
-        char_src = (char *)src + count - 1;
+        /* overlapping buffers, copying upwards: go backward */
+        char_dest += count;
+        char_src += count;
+
+        if ((count >= 2 * sizeof(size_t)) &&
+            ((((size_t)char_dest ^ (size_t)char_src) & (sizeof(size_t) - 1)) == 0))
+        {
+            while ((size_t)char_dest & (sizeof(size_t) - 1))
+            {
+                *--char_dest = *--char_src;
+                count--;
+            }
+            while (count >= sizeof(size_t))
+            {
+                char_dest -= sizeof(size_t);
+                char_src -= sizeof(size_t);
+                *(size_t *)char_dest = *(const size_t *)char_src;
+                count -= sizeof(size_t);
+            }
+        }
 
-        while(count > 0)
-	{
-           *char_dest = *char_src;
-           char_dest--;
-           char_src--;
-           count--;
-	}
+        while (count > 0)
+        {
+            *--char_dest = *--char_src;
+            count--;
+        }
     }
 
     return dest;
@@ -1,4 +1,3 @@
-
 #include <string.h>
 
 #ifdef _MSC_VER
@@ -7,10 +6,34 @@
 
 void* __cdecl memset(void* src, int val, size_t count)
 {
-    char *char_src = (char *)src;
+    unsigned char *char_src = (unsigned char *)src;
+    size_t pattern;
+
+    if (count >= 2 * sizeof(size_t))
+    {
+        /* Align the destination, then store whole words */
+        while ((size_t)char_src & (sizeof(size_t) - 1))
+        {
+            *char_src++ = (unsigned char)val;
+            count--;
+        }
+
+        /* Replicate the byte value in every byte of the word */
+        pattern = (unsigned char)val;
+        pattern |= pattern << 8;
+        pattern |= pattern << 16;
+        pattern |= (pattern << 16) << 16; /* No-op for 32-bit words */
+
+        while (count >= sizeof(size_t))
+        {
+            *(size_t *)char_src = pattern;
+            char_src += sizeof(size_t);
+            count -= sizeof(size_t);
+        }
+    }
 
     while(count>0) {
-        *char_src = val;
+        *char_src = (unsigned char)val;
         char_src++;
         count--;
     }
@@ -81,34 +81,71 @@ med3(char *a, char *b, char *c, int (__cdecl *cmp)(const void*, const void*))
 }
 
 /*
- * qsort:
- * First, set up some global parameters for qst to share.  Then, quicksort
- * with qst(), and then a cleanup insertion sort ourselves.  Sound simple?
- * It's not...
- *
- * @implemented
+ * Heapsort, used when the quicksort recursion gets too deep.
  */
-void
-__cdecl
-qsort(void *a, size_t n, size_t es, int (__cdecl *cmp)(const void*, const void*))
+static void
+hsift(char *a, size_t root, size_t n, size_t es, int swaptype,
+    int (__cdecl *cmp)(const void*, const void*))
+{
+	size_t child;
+
+	while ((child = 2 * root + 1) < n) {
+		if (child + 1 < n &&
+		    CMP(a + child * es, a + (child + 1) * es) < 0)
+			child++;
+		if (CMP(a + root * es, a + child * es) >= 0)
+			return;
+		swap(a + root * es, a + child * es);
+		root = child;
+	}
+}
+
+static void
+hsort(char *a, size_t n, size_t es, int swaptype,
+    int (__cdecl *cmp)(const void*, const void*))
+{
+	size_t i;
+
+	for (i = n / 2; i > 0; i--)
+		hsift(a, i - 1, n, es, swaptype, cmp);
+	for (i = n - 1; i > 0; i--) {
+		swap(a, a + i * es);
+		hsift(a, 0, i, es, swaptype, cmp);
+	}
+}
+
+/*
+ * introsort:
+ * Quicksort with a three-way partition around a pseudo-median pivot, and
+ * an insertion sort for the small subarrays.  Only the smaller partition is
+ * sorted recursively, and once depth levels have been used up the rest is
+ * heapsorted, which keeps the worst case at O(n log n) time and
+ * O(log n) stack.
+ */
+static void
+introsort(char *a, size_t n, size_t es,
+    int (__cdecl *cmp)(const void*, const void*), int depth)
 {
 	char *pa, *pb, *pc, *pd, *pl, *pm, *pn;
-	int swaptype, swap_cnt;
-	intptr_t d, r;
+	int swaptype;
+	intptr_t d, r, rl, rr;
 
 loop:	SWAPINIT(a, es);
-	swap_cnt = 0;
 	if (n < 7) {
-		for (pm = (char *)a + es; pm < (char *)a + n * es; pm += es)
-			for (pl = pm; pl > (char *)a && CMP(pl - es, pl) > 0;
+		for (pm = a + es; pm < a + n * es; pm += es)
+			for (pl = pm; pl > a && CMP(pl - es, pl) > 0;
 			     pl -= es)
 				swap(pl, pl - es);
 		return;
 	}
-	pm = (char *)a + (n / 2) * es;
+	if (depth-- == 0) {
+		hsort(a, n, es, swaptype, cmp);
+		return;
+	}
+	pm = a + (n / 2) * es;
 	if (n > 7) {
 		pl = a;
-		pn = (char *)a + (n - 1) * es;
+		pn = a + (n - 1) * es;
 		if (n > 40) {
 			d = (n / 8) * es;
 			pl = med3(pl, pl + d, pl + 2 * d, cmp);
@@ -118,13 +155,12 @@ loop:	SWAPINIT(a, es);
 		pm = med3(pl, pm, pn, cmp);
 	}
 	swap(a, pm);
-	pa = pb = (char *)a + es;
+	pa = pb = a + es;
 
-	pc = pd = (char *)a + (n - 1) * es;
+	pc = pd = a + (n - 1) * es;
 	for (;;) {
 		while (pb <= pc && (r = CMP(pb, a)) <= 0) {
 			if (r == 0) {
-				swap_cnt = 1;
 				swap(pa, pb);
 				pa += es;
 			}
@@ -132,7 +168,6 @@ loop:	SWAPINIT(a, es);
 		}
 		while (pb <= pc && (r = CMP(pc, a)) >= 0) {
 			if (r == 0) {
-				swap_cnt = 1;
 				swap(pc, pd);
 				pd -= es;
 			}
@@ -141,29 +176,53 @@ loop:	SWAPINIT(a, es);
 		if (pb > pc)
 			break;
 		swap(pb, pc);
-		swap_cnt = 1;
 		pb += es;
 		pc -= es;
 	}
-	if (swap_cnt == 0) {  /* Switch to insertion sort */
-		for (pm = (char *)a + es; pm < (char *)a + n * es; pm += es)
-			for (pl = pm; pl > (char *)a && CMP(pl - es, pl) > 0;
-			     pl -= es)
-				swap(pl, pl - es);
-		return;
-	}
 
-	pn = (char *)a + n * es;
-	r = min(pa - (char *)a, pb - pa);
+	pn = a + n * es;
+	r = min(pa - a, pb - pa);
 	vecswap(a, pb - r, r);
 	r = min(pd - pc, pn - pd - es);
 	vecswap(pb, pn - r, r);
-	if ((r = pb - pa) > es)
-		qsort(a, r / es, es, cmp);
-	if ((r = pd - pc) > es) {
-		/* Iterate rather than recurse to save stack space */
-		a = pn - r;
-		n = r / es;
-		goto loop;
+
+	/* Recurse into the smaller side, iterate on the larger one */
+	rl = pb - pa;
+	rr = pd - pc;
+	if (rl <= rr) {
+		if (rl > (intptr_t)es)
+			introsort(a, rl / es, es, cmp, depth);
+		if (rr > (intptr_t)es) {
+			a = pn - rr;
+			n = rr / es;
+			goto loop;
+		}
+	} else {
+		if (rr > (intptr_t)es)
+			introsort(pn - rr, rr / es, es, cmp, depth);
+		if (rl > (intptr_t)es) {
+			n = rl / es;
+			goto loop;
+		}
 	}
 }
+
+/*
+ * qsort:
+ * Introsort the array, allowing about 2 log2(n) levels of quicksort
+ * before falling back to heapsort.
+ *
+ * @implemented
+ */
+void
+__cdecl
+qsort(void *a, size_t n, size_t es, int (__cdecl *cmp)(const void*, const void*))
+{
+	int depth = 0;
+	size_t i;
+
+	for (i = n; i > 1; i >>= 1)
+		depth += 2;
+
+	introsort(a, n, es, cmp, depth);
+}
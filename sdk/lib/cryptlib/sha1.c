@@ -24,8 +24,7 @@
 #define rol(value, bits) (((value) << (bits)) | ((value) >> (32 - (bits))))
 /* FIXME: This definition of DWORD2BE is little endian specific! */
 #define DWORD2BE(x) (((x) >> 24) & 0xff) | (((x) >> 8) & 0xff00) | (((x) << 8) & 0xff0000) | (((x) << 24) & 0xff000000);
-/* FIXME: This definition of blk0 is little endian specific! */
-#define blk0(i) (Block[i] = (rol(Block[i],24)&0xFF00FF00)|(rol(Block[i],8)&0x00FF00FF))
+#define blk0(i) (Block[i])
 #define blk1(i) (Block[i&15] = rol(Block[(i+13)&15]^Block[(i+8)&15]^Block[(i+2)&15]^Block[i&15],1))
 #define f1(x,y,z) (z^(x&(y^z)))
 #define f2(x,y,z) (x^y^z)
@@ -39,12 +38,16 @@
 #define R4(v,w,x,y,z,i) z+=f4(w,x,y)+blk1(i)+0xCA62C1D6+rol(v,5);w=rol(w,30);
 
 /* Hash a single 512-bit block. This is the core of the algorithm. */
-static void SHA1Transform(ULONG State[5], UCHAR Buffer[64])
+static void SHA1Transform(ULONG State[5], const UCHAR Buffer[64])
 {
    ULONG a, b, c, d, e;
-   ULONG *Block;
+   ULONG Block[16];
+   INT i;
 
-   Block = (ULONG*)Buffer;
+   /* Load the big endian words of the block, it may be unaligned */
+   for (i = 0; i < 16; i++, Buffer += 4)
+      Block[i] = ((ULONG)Buffer[0] << 24) | ((ULONG)Buffer[1] << 16) |
+                 ((ULONG)Buffer[2] << 8) | (ULONG)Buffer[3];
 
    /* Copy Context->State[] to working variables */
    a = State[0];
@@ -142,16 +145,24 @@ A_SHAUpdate(PSHA_CTX Context, const unsigned char *Buffer, ULONG BufferSize)
    }
    else
    {
-      while (BufferContentSize + BufferSize >= 64)
+      /* Complete the pending block first */
+      if (BufferContentSize)
       {
          memcpy(Context->Buffer + BufferContentSize, Buffer,
                        64 - BufferContentSize);
          Buffer += 64 - BufferContentSize;
          BufferSize -= 64 - BufferContentSize;
          SHA1Transform(Context->State, Context->Buffer);
-         BufferContentSize = 0;
       }
-      memcpy(Context->Buffer + BufferContentSize, Buffer, BufferSize);
+
+      /* Hash the following whole blocks in place */
+      while (BufferSize >= 64)
+      {
+         SHA1Transform(Context->State, Buffer);
+         Buffer += 64;
+         BufferSize -= 64;
+      }
+      memcpy(Context->Buffer, Buffer, BufferSize);
    }
 }
 
@@ -200,6 +200,22 @@ ElfpOffsetByNumber(
 {
     UINT i;
 
+    if (LogFile->OffsetInfoNext == 0)
+        return 0;
+
+    /*
+     * The offset information is listed in increasing order and without holes,
+     * so the record normally sits at its distance from the oldest one.
+     * Fall back to a linear search only if this is not the case (e.g. when
+     * the record numbers wrapped around).
+     */
+    i = RecordNumber - LogFile->OffsetInfo[0].EventNumber;
+    if (i < LogFile->OffsetInfoNext &&
+        LogFile->OffsetInfo[i].EventNumber == RecordNumber)
+    {
+        return LogFile->OffsetInfo[i].EventOffset;
+    }
+
     for (i = 0; i < LogFile->OffsetInfoNext; i++)
     {
         if (LogFile->OffsetInfo[i].EventNumber == RecordNumber)
@@ -257,38 +273,32 @@ ElfpDeleteOffsetInformation(
     IN ULONG ulNumberMin,
     IN ULONG ulNumberMax)
 {
-    UINT i;
+    UINT i, Count;
 
     if (ulNumberMin > ulNumberMax)
         return FALSE;
 
-    /* Remove records ulNumberMin to ulNumberMax inclusive */
-    while (ulNumberMin <= ulNumberMax)
+    /*
+     * As the offset information is listed in increasing order, and we want
+     * to keep the list without holes, we demand that records ulNumberMin to
+     * ulNumberMax are the first elements in the list.
+     */
+    Count = ulNumberMax - ulNumberMin + 1;
+    if (Count > LogFile->OffsetInfoNext)
+        return FALSE;
+
+    for (i = 0; i < Count; i++)
     {
-        /*
-         * As the offset information is listed in increasing order, and we want
-         * to keep the list without holes, we demand that ulNumberMin is the first
-         * element in the list.
-         */
-        if (ulNumberMin != LogFile->OffsetInfo[0].EventNumber)
+        if (LogFile->OffsetInfo[i].EventNumber != ulNumberMin + i)
             return FALSE;
-
-        /*
-         * RtlMoveMemory(&LogFile->OffsetInfo[0],
-         *               &LogFile->OffsetInfo[1],
-         *               sizeof(EVENT_OFFSET_INFO) * (LogFile->OffsetInfoNext - 1));
-         */
-        for (i = 0; i < LogFile->OffsetInfoNext - 1; i++)
-        {
-            LogFile->OffsetInfo[i].EventNumber = LogFile->OffsetInfo[i + 1].EventNumber;
-            LogFile->OffsetInfo[i].EventOffset = LogFile->OffsetInfo[i + 1].EventOffset;
-        }
-        LogFile->OffsetInfoNext--;
-
-        /* Go to the next offset information */
-        ulNumberMin++;
     }
 
+    /* Remove records ulNumberMin to ulNumberMax inclusive, all at once */
+    RtlMoveMemory(&LogFile->OffsetInfo[0],
+                  &LogFile->OffsetInfo[Count],
+                  sizeof(EVENT_OFFSET_INFO) * (LogFile->OffsetInfoNext - Count));
+    LogFile->OffsetInfoNext -= Count;
+
     return TRUE;
 }
 
@@ -372,6 +382,9 @@ ElfpInitNewFile(
         return Status;
     }
 
+    /* The log file is now empty and clean on disk */
+    LogFile->FlushPending = FALSE;
+
     return STATUS_SUCCESS;
 }
 
@@ -1171,6 +1184,9 @@ ElfFlushFile(
         return Status;
     }
 
+    /* The records written so far are now committed */
+    LogFile->FlushPending = FALSE;
+
     return STATUS_SUCCESS;
 }
 
@@ -1498,6 +1514,30 @@ ElfWriteRecord(
     /* Since we can write events in the log, clear the log full flag */
     LogFile->Header.Flags &= ~ELF_LOGFILE_LOGFULL_WRITTEN;
 
+    /*
+     * The log file is not flushed after each record: the caller commits
+     * a group of records at once by calling ElfFlushFile(). However, mark
+     * the log header as dirty on disk with the first record of the group,
+     * before modifying the log contents, so that the log is recovered from
+     * its EOF record if it does not get properly flushed.
+     */
+    if (!LogFile->FlushPending)
+    {
+        FileOffset.QuadPart = 0LL;
+        Status = LogFile->FileWrite(LogFile,
+                                    &FileOffset,
+                                    &LogFile->Header,
+                                    sizeof(EVENTLOGHEADER),
+                                    &WrittenLength);
+        if (!NT_SUCCESS(Status))
+        {
+            EVTLTRACE1("FileWrite() failed (Status 0x%08lx)\n", Status);
+            return STATUS_EVENTLOG_FILE_CORRUPT; // Status;
+        }
+
+        LogFile->FlushPending = TRUE;
+    }
+
     /* Pad the end of the log */
     // if (LogFile->Header.EndOffset + sizeof(RecBuf) > LogFile->Header.MaxSize)
     if (WriteOffset < LogFile->Header.EndOffset)
@@ -1573,14 +1613,6 @@ ElfWriteRecord(
     }
     FileOffset = NextOffset;
 
-    /* Flush the log file */
-    Status = ElfFlushFile(LogFile);
-    if (!NT_SUCCESS(Status))
-    {
-        EVTLTRACE1("ElfFlushFile() failed (Status 0x%08lx)\n", Status);
-        return STATUS_EVENTLOG_FILE_CORRUPT; // Status;
-    }
-
     return Status;
 }
 
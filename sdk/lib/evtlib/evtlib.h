@@ -215,6 +215,7 @@ typedef struct _EVTLOGFILE
     ULONG OffsetInfoSize;
     ULONG OffsetInfoNext;
     BOOLEAN ReadOnly;
+    BOOLEAN FlushPending;   /* Records have been written since the last ElfFlushFile() call */
 } EVTLOGFILE, *PEVTLOGFILE;
 
 
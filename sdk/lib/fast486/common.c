@@ -111,42 +111,38 @@ Fast486ReadMemory(PFAST486_STATE State,
     LinearAddress = CachedDescriptor->Base + Offset;
 
 #ifndef FAST486_NO_PREFETCH
-    if (InstFetch && ((Offset + FAST486_CACHE_SIZE - 1) <= CachedDescriptor->Limit))
+    if (InstFetch && ((CACHE_LINE_OFFSET(LinearAddress) + Size) <= FAST486_CACHE_SIZE))
     {
-        State->PrefetchAddress = LinearAddress;
+        PFAST486_CACHE_LINE CacheLine = &State->CodeCache[CACHE_LINE_INDEX(State, LinearAddress)];
 
-        if ((State->ControlRegisters[FAST486_REG_CR0] & FAST486_CR0_PG)
-            && (PAGE_OFFSET(State->PrefetchAddress) > (FAST486_PAGE_SIZE - FAST486_CACHE_SIZE)))
+        if (State->ControlRegisters[FAST486_REG_CR0] & FAST486_CR0_PG)
         {
-            /* We mustn't prefetch across a page boundary */
-            State->PrefetchAddress = PAGE_ALIGN(State->PrefetchAddress)
-                                     | (FAST486_PAGE_SIZE - FAST486_CACHE_SIZE);
-
-            if ((LinearAddress - State->PrefetchAddress + Size) >= FAST486_CACHE_SIZE)
-            {
-                /* We can't prefetch without possibly violating page permissions */
-                State->PrefetchValid = FALSE;
-                return Fast486ReadLinearMemory(State, LinearAddress, Buffer, Size, TRUE);
-            }
+            /*
+             * With paging, several linear addresses can map the same physical
+             * page and writes through one of them would not invalidate lines
+             * cached through the others, so keep only one line in that case.
+             */
+            Fast486FlushCodeCache(State);
         }
 
-        /* Prefetch */
+        /* Prefetch the whole line, it never crosses a page boundary */
         if (Fast486ReadLinearMemory(State,
-                                    State->PrefetchAddress,
-                                    State->PrefetchCache,
+                                    CACHE_LINE_ALIGN(LinearAddress),
+                                    CacheLine->Data,
                                     FAST486_CACHE_SIZE,
                                     TRUE))
         {
-            State->PrefetchValid = TRUE;
+            CacheLine->Address = CACHE_LINE_ALIGN(LinearAddress);
+            CacheLine->Generation = State->CacheGeneration;
 
             RtlMoveMemory(Buffer,
-                          &State->PrefetchCache[LinearAddress - State->PrefetchAddress],
+                          &CacheLine->Data[CACHE_LINE_OFFSET(LinearAddress)],
                           Size);
             return TRUE;
         }
         else
         {
-            State->PrefetchValid = FALSE;
+            CacheLine->Generation = 0;
             return FALSE;
         }
     }
@@ -230,18 +226,6 @@ Fast486WriteMemory(PFAST486_STATE State,
     /* Find the linear address */
     LinearAddress = CachedDescriptor->Base + Offset;
 
-#ifndef FAST486_NO_PREFETCH
-    if (State->PrefetchValid
-        && (LinearAddress >= State->PrefetchAddress)
-        && ((LinearAddress + Size) <= (State->PrefetchAddress + FAST486_CACHE_SIZE)))
-    {
-        /* Update the prefetch */
-        RtlMoveMemory(&State->PrefetchCache[LinearAddress - State->PrefetchAddress],
-                      Buffer,
-                      min(Size, FAST486_CACHE_SIZE + State->PrefetchAddress - LinearAddress));
-    }
-#endif
-
     /* Write to the linear address */
     return Fast486WriteLinearMemory(State, LinearAddress, Buffer, Size, TRUE);
 }
@@ -909,7 +893,7 @@ Fast486TaskSwitch(PFAST486_STATE State, FAST486_TASK_SWITCH_TYPE Type, USHORT Se
 
 #ifndef FAST486_NO_PREFETCH
     /* Context switching invalidates the prefetch */
-    State->PrefetchValid = FALSE;
+    Fast486FlushCodeCache(State);
 #endif
 
     /* Load the registers */
@@ -71,6 +71,10 @@ if (State->PrefixFlags & FAST486_PREFIX_LOCK)\
 #define INVALID_TLB_FIELD 0xFFFFFFFF
 #define NUM_TLB_ENTRIES 0x100000
 
+#define CACHE_LINE_ALIGN(x)     ((x) & ~(FAST486_CACHE_SIZE - 1))
+#define CACHE_LINE_OFFSET(x)    ((x) & (FAST486_CACHE_SIZE - 1))
+#define CACHE_LINE_INDEX(s, x)  (((x) / FAST486_CACHE_SIZE) & (s)->CodeCacheMask)
+
 typedef struct _FAST486_MOD_REG_RM
 {
     FAST486_GEN_REGS Register;
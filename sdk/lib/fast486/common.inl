@@ -155,6 +155,153 @@ Fast486FlushTlb(PFAST486_STATE State)
     State->TlbEmpty = TRUE;
 }
 
+#ifndef FAST486_NO_PREFETCH
+
+FORCEINLINE
+VOID
+FASTCALL
+Fast486FlushCodeCache(PFAST486_STATE State)
+{
+    /* Bumping the generation invalidates all the lines at once */
+    if (++State->CacheGeneration == 0)
+    {
+        /* The counter wrapped around, make sure no stale line can match */
+        RtlZeroMemory(State->CodeCache, (State->CodeCacheMask + 1) * sizeof(FAST486_CACHE_LINE));
+        State->CacheGeneration = 1;
+    }
+}
+
+FORCEINLINE
+VOID
+FASTCALL
+Fast486InvalidateCodeCache(PFAST486_STATE State,
+                           ULONG LinearAddress,
+                           ULONG Size)
+{
+    ULONG Line, FirstLine, LastLine;
+    PFAST486_CACHE_LINE CacheLine;
+
+    if (Size == 0) return;
+
+    FirstLine = LinearAddress / FAST486_CACHE_SIZE;
+    LastLine = (LinearAddress + Size - 1) / FAST486_CACHE_SIZE;
+
+    if ((LastLine < FirstLine) || ((LastLine - FirstLine) > State->CodeCacheMask))
+    {
+        /* The range covers the whole cache anyway */
+        Fast486FlushCodeCache(State);
+        return;
+    }
+
+    for (Line = FirstLine; Line <= LastLine; Line++)
+    {
+        CacheLine = &State->CodeCache[Line & State->CodeCacheMask];
+
+        /* Drop the line if it caches this address */
+        if (CacheLine->Address == Line * FAST486_CACHE_SIZE) CacheLine->Generation = 0;
+    }
+}
+
+FORCEINLINE
+PUCHAR
+FASTCALL
+Fast486GetCachedCode(PFAST486_STATE State,
+                     ULONG Offset,
+                     ULONG Size)
+{
+    PFAST486_SEG_REG CachedDescriptor = &State->SegmentRegs[FAST486_REG_CS];
+    ULONG LinearAddress = CachedDescriptor->Base + Offset;
+    PFAST486_CACHE_LINE CacheLine = &State->CodeCache[CACHE_LINE_INDEX(State, LinearAddress)];
+
+    if ((CacheLine->Generation != State->CacheGeneration)
+        || (CacheLine->Address != CACHE_LINE_ALIGN(LinearAddress))
+        || ((CACHE_LINE_OFFSET(LinearAddress) + Size) > FAST486_CACHE_SIZE)
+        || ((Offset + Size - 1) > CachedDescriptor->Limit))
+    {
+        /* Not cached, or the fetch must go through the usual checks */
+        return NULL;
+    }
+
+    return &CacheLine->Data[CACHE_LINE_OFFSET(LinearAddress)];
+}
+
+#endif
+
+FORCEINLINE
+VOID
+FASTCALL
+Fast486MoveMemory(PVOID Destination,
+                  PVOID Source,
+                  ULONG Size)
+{
+    /* Most of the accesses are small, avoid calling RtlMoveMemory for them */
+    switch (Size)
+    {
+        case sizeof(UCHAR):
+            *(PUCHAR)Destination = *(PUCHAR)Source;
+            break;
+
+        case sizeof(USHORT):
+            *(PUSHORT)Destination = *(PUSHORT)Source;
+            break;
+
+        case sizeof(ULONG):
+            *(PULONG)Destination = *(PULONG)Source;
+            break;
+
+        default:
+            RtlMoveMemory(Destination, Source, Size);
+    }
+}
+
+FORCEINLINE
+VOID
+FASTCALL
+Fast486ReadPhysicalMemory(PFAST486_STATE State,
+                          ULONG Address,
+                          PVOID Buffer,
+                          ULONG Size)
+{
+    ULONG Page = Address / FAST486_PAGE_SIZE;
+
+    if ((Page < State->MemoryMapPages)
+        && ((PAGE_OFFSET(Address) + Size) <= FAST486_PAGE_SIZE)
+        && (State->MemoryMap[Page] != NULL))
+    {
+        /* This is plain RAM, read it directly */
+        Fast486MoveMemory(Buffer, State->MemoryMap[Page] + PAGE_OFFSET(Address), Size);
+    }
+    else
+    {
+        /* Let the host handle it */
+        State->MemReadCallback(State, Address, Buffer, Size);
+    }
+}
+
+FORCEINLINE
+VOID
+FASTCALL
+Fast486WritePhysicalMemory(PFAST486_STATE State,
+                           ULONG Address,
+                           PVOID Buffer,
+                           ULONG Size)
+{
+    ULONG Page = Address / FAST486_PAGE_SIZE;
+
+    if ((Page < State->MemoryMapPages)
+        && ((PAGE_OFFSET(Address) + Size) <= FAST486_PAGE_SIZE)
+        && (State->MemoryMap[Page] != NULL))
+    {
+        /* This is plain RAM, write it directly */
+        Fast486MoveMemory(State->MemoryMap[Page] + PAGE_OFFSET(Address), Buffer, Size);
+    }
+    else
+    {
+        /* Let the host handle it */
+        State->MemWriteCallback(State, Address, Buffer, Size);
+    }
+}
+
 FORCEINLINE
 BOOLEAN
 FASTCALL
@@ -208,10 +355,10 @@ Fast486ReadLinearMemory(PFAST486_STATE State,
             }
 
             /* Read the memory */
-            State->MemReadCallback(State,
-                                   (TableEntry.Address << 12) | PageOffset,
-                                   (PVOID)((ULONG_PTR)Buffer + BufferOffset),
-                                   PageLength);
+            Fast486ReadPhysicalMemory(State,
+                                      (TableEntry.Address << 12) | PageOffset,
+                                      (PVOID)((ULONG_PTR)Buffer + BufferOffset),
+                                      PageLength);
 
             BufferOffset += PageLength;
         }
@@ -219,7 +366,7 @@ Fast486ReadLinearMemory(PFAST486_STATE State,
     else
     {
         /* Read the memory */
-        State->MemReadCallback(State, LinearAddress, Buffer, Size);
+        Fast486ReadPhysicalMemory(State, LinearAddress, Buffer, Size);
     }
 
     return TRUE;
@@ -234,6 +381,11 @@ Fast486WriteLinearMemory(PFAST486_STATE State,
                          ULONG Size,
                          BOOLEAN CheckPrivilege)
 {
+#ifndef FAST486_NO_PREFETCH
+    /* Any cached code in this range is now stale */
+    Fast486InvalidateCodeCache(State, LinearAddress, Size);
+#endif
+
     /* Check if paging is enabled */
     if (State->ControlRegisters[FAST486_REG_CR0] & FAST486_CR0_PG)
     {
@@ -281,10 +433,10 @@ Fast486WriteLinearMemory(PFAST486_STATE State,
             }
 
             /* Write the memory */
-            State->MemWriteCallback(State,
-                                    (TableEntry.Address << 12) | PageOffset,
-                                    (PVOID)((ULONG_PTR)Buffer + BufferOffset),
-                                    PageLength);
+            Fast486WritePhysicalMemory(State,
+                                       (TableEntry.Address << 12) | PageOffset,
+                                       (PVOID)((ULONG_PTR)Buffer + BufferOffset),
+                                       PageLength);
 
             BufferOffset += PageLength;
         }
@@ -292,7 +444,7 @@ Fast486WriteLinearMemory(PFAST486_STATE State,
     else
     {
         /* Write the memory */
-        State->MemWriteCallback(State, LinearAddress, Buffer, Size);
+        Fast486WritePhysicalMemory(State, LinearAddress, Buffer, Size);
     }
 
     return TRUE;
@@ -643,7 +795,7 @@ Fast486LoadSegmentInternal(PFAST486_STATE State,
 
 #ifndef FAST486_NO_PREFETCH
             /* Invalidate the prefetch */
-            State->PrefetchValid = FALSE;
+            Fast486FlushCodeCache(State);
 #endif
 
             if (!(Selector & SEGMENT_TABLE_INDICATOR) && GET_SEGMENT_INDEX(Selector) == 0)
@@ -862,7 +1014,7 @@ Fast486FetchByte(PFAST486_STATE State,
     PFAST486_SEG_REG CachedDescriptor;
     ULONG Offset;
 #ifndef FAST486_NO_PREFETCH
-    ULONG LinearAddress;
+    PUCHAR CachedCode;
 #endif
 
     /* Get the cached descriptor of CS */
@@ -871,13 +1023,11 @@ Fast486FetchByte(PFAST486_STATE State,
     Offset = (CachedDescriptor->Size) ? State->InstPtr.Long
                                       : State->InstPtr.LowWord;
 #ifndef FAST486_NO_PREFETCH
-    LinearAddress = CachedDescriptor->Base + Offset;
+    CachedCode = Fast486GetCachedCode(State, Offset, sizeof(UCHAR));
 
-    if (State->PrefetchValid
-        && (LinearAddress >= State->PrefetchAddress)
-        && ((LinearAddress + sizeof(UCHAR)) <= (State->PrefetchAddress + FAST486_CACHE_SIZE)))
+    if (CachedCode != NULL)
     {
-        *Data = *(PUCHAR)&State->PrefetchCache[LinearAddress - State->PrefetchAddress];
+        *Data = *(PUCHAR)CachedCode;
     }
     else
 #endif
@@ -911,7 +1061,7 @@ Fast486FetchWord(PFAST486_STATE State,
     PFAST486_SEG_REG CachedDescriptor;
     ULONG Offset;
 #ifndef FAST486_NO_PREFETCH
-    ULONG LinearAddress;
+    PUCHAR CachedCode;
 #endif
 
     /* Get the cached descriptor of CS */
@@ -921,13 +1071,11 @@ Fast486FetchWord(PFAST486_STATE State,
                                       : State->InstPtr.LowWord;
 
 #ifndef FAST486_NO_PREFETCH
-    LinearAddress = CachedDescriptor->Base + Offset;
+    CachedCode = Fast486GetCachedCode(State, Offset, sizeof(USHORT));
 
-    if (State->PrefetchValid
-        && (LinearAddress >= State->PrefetchAddress)
-        && ((LinearAddress + sizeof(USHORT)) <= (State->PrefetchAddress + FAST486_CACHE_SIZE)))
+    if (CachedCode != NULL)
     {
-        *Data = *(PUSHORT)&State->PrefetchCache[LinearAddress - State->PrefetchAddress];
+        *Data = *(PUSHORT)CachedCode;
     }
     else
 #endif
@@ -962,7 +1110,7 @@ Fast486FetchDword(PFAST486_STATE State,
     PFAST486_SEG_REG CachedDescriptor;
     ULONG Offset;
 #ifndef FAST486_NO_PREFETCH
-    ULONG LinearAddress;
+    PUCHAR CachedCode;
 #endif
 
     /* Get the cached descriptor of CS */
@@ -972,13 +1120,11 @@ Fast486FetchDword(PFAST486_STATE State,
                                       : State->InstPtr.LowWord;
 
 #ifndef FAST486_NO_PREFETCH
-    LinearAddress = CachedDescriptor->Base + Offset;
+    CachedCode = Fast486GetCachedCode(State, Offset, sizeof(ULONG));
 
-    if (State->PrefetchValid
-        && (LinearAddress >= State->PrefetchAddress)
-        && ((LinearAddress + sizeof(ULONG)) <= (State->PrefetchAddress + FAST486_CACHE_SIZE)))
+    if (CachedCode != NULL)
     {
-        *Data = *(PULONG)&State->PrefetchCache[LinearAddress - State->PrefetchAddress];
+        *Data = *(PULONG)CachedCode;
     }
     else
 #endif
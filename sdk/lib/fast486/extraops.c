@@ -637,7 +637,7 @@ FAST486_OPCODE_HANDLER(Fast486ExtOpcodeLoadControlReg)
 
 #ifndef FAST486_NO_PREFETCH
     /* Changing CR0 or CR3 can interfere with prefetching (because of paging) */
-    State->PrefetchValid = FALSE;
+    Fast486FlushCodeCache(State);
 #endif
 
     if (ModRegRm.Register == (INT)FAST486_REG_CR3)
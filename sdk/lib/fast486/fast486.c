@@ -122,6 +122,16 @@ Fast486Initialize(PFAST486_STATE         State,
     /* Set the TLB (if given) */
     State->Tlb = Tlb;
 
+    /* No direct memory map until Fast486SetMemoryMap is called */
+    State->MemoryMap      = NULL;
+    State->MemoryMapPages = 0;
+
+#ifndef FAST486_NO_PREFETCH
+    /* Only one prefetch line until Fast486SetCodeCache is called */
+    State->CodeCache     = NULL;
+    State->CodeCacheMask = 0;
+#endif
+
     /* Reset the CPU */
     Fast486Reset(State);
 }
@@ -132,7 +142,7 @@ Fast486Reset(PFAST486_STATE State)
 {
     FAST486_SEG_REGS i;
 
-    /* Save the callbacks and TLB */
+    /* Save the callbacks, TLB, memory map and code cache */
     FAST486_MEM_READ_PROC  MemReadCallback  = State->MemReadCallback;
     FAST486_MEM_WRITE_PROC MemWriteCallback = State->MemWriteCallback;
     FAST486_IO_READ_PROC   IoReadCallback   = State->IoReadCallback;
@@ -141,6 +151,12 @@ Fast486Reset(PFAST486_STATE State)
     FAST486_INT_ACK_PROC   IntAckCallback   = State->IntAckCallback;
     FAST486_FPU_PROC       FpuCallback      = State->FpuCallback;
     PULONG                 Tlb              = State->Tlb;
+    PUCHAR                *MemoryMap        = State->MemoryMap;
+    ULONG                  MemoryMapPages   = State->MemoryMapPages;
+#ifndef FAST486_NO_PREFETCH
+    PFAST486_CACHE_LINE    CodeCache        = State->CodeCache;
+    ULONG                  CodeCacheMask    = State->CodeCacheMask;
+#endif
 
     /* Clear the entire structure */
     RtlZeroMemory(State, sizeof(*State));
@@ -186,7 +202,7 @@ Fast486Reset(PFAST486_STATE State)
     State->FpuTag = 0xFFFF;
 #endif
 
-    /* Restore the callbacks and TLB */
+    /* Restore the callbacks, TLB, memory map and code cache */
     State->MemReadCallback  = MemReadCallback;
     State->MemWriteCallback = MemWriteCallback;
     State->IoReadCallback   = IoReadCallback;
@@ -195,6 +211,27 @@ Fast486Reset(PFAST486_STATE State)
     State->IntAckCallback   = IntAckCallback;
     State->FpuCallback      = FpuCallback;
     State->Tlb              = Tlb;
+    State->MemoryMap        = MemoryMap;
+    State->MemoryMapPages   = MemoryMapPages;
+
+#ifndef FAST486_NO_PREFETCH
+    if (CodeCache == NULL || CodeCache == &State->PrefetchLine)
+    {
+        /* Use the single prefetch line of the state */
+        State->CodeCache     = &State->PrefetchLine;
+        State->CodeCacheMask = 0;
+    }
+    else
+    {
+        /* The lines given by the host may still hold code of a previous run */
+        State->CodeCache     = CodeCache;
+        State->CodeCacheMask = CodeCacheMask;
+        RtlZeroMemory(CodeCache, (CodeCacheMask + 1) * sizeof(FAST486_CACHE_LINE));
+    }
+
+    /* Start with an empty prefetch cache */
+    State->CacheGeneration = 1;
+#endif
 
     /* Flush the TLB */
     Fast486FlushTlb(State);
@@ -256,7 +293,84 @@ Fast486Rewind(PFAST486_STATE State)
     State->InstPtr.Long = State->SavedInstPtr.Long;
 
 #ifndef FAST486_NO_PREFETCH
-    State->PrefetchValid = FALSE;
+    Fast486FlushCodeCache(State);
+#endif
+}
+
+VOID
+NTAPI
+Fast486SetMemoryMap(PFAST486_STATE State, PUCHAR *MemoryMap, ULONG NumPages)
+{
+    /*
+     * The memory map gives the host address of each physical page that
+     * can be accessed directly, or NULL if the memory callbacks must be used
+     */
+    State->MemoryMap = MemoryMap;
+    State->MemoryMapPages = (MemoryMap != NULL) ? NumPages : 0;
+}
+
+VOID
+NTAPI
+Fast486SetCodeCache(PFAST486_STATE State, PFAST486_CACHE_LINE CodeCache, ULONG NumLines)
+{
+#ifndef FAST486_NO_PREFETCH
+    /*
+     * The code cache is not part of the state, so that hosts keeping the
+     * state on a small stack (the HAL x86 BIOS emulator) do not pay for it.
+     * The number of lines must be a power of two.
+     */
+    ASSERT((NumLines & (NumLines - 1)) == 0);
+
+    if (CodeCache == NULL || NumLines == 0)
+    {
+        CodeCache = &State->PrefetchLine;
+        NumLines = 1;
+    }
+
+    RtlZeroMemory(CodeCache, NumLines * sizeof(FAST486_CACHE_LINE));
+    State->CodeCache = CodeCache;
+    State->CodeCacheMask = NumLines - 1;
+    State->CacheGeneration = 1;
+#else
+    UNREFERENCED_PARAMETER(State);
+    UNREFERENCED_PARAMETER(CodeCache);
+    UNREFERENCED_PARAMETER(NumLines);
+#endif
+}
+
+VOID
+NTAPI
+Fast486FlushCache(PFAST486_STATE State)
+{
+#ifndef FAST486_NO_PREFETCH
+    Fast486FlushCodeCache(State);
+#else
+    UNREFERENCED_PARAMETER(State);
+#endif
+}
+
+VOID
+NTAPI
+Fast486InvalidateCache(PFAST486_STATE State, ULONG Address, ULONG Size)
+{
+    /*
+     * This function is used when the host modifies the guest physical
+     * memory behind the back of the CPU (DMA transfers, for example)
+     */
+#ifndef FAST486_NO_PREFETCH
+    if (State->ControlRegisters[FAST486_REG_CR0] & FAST486_CR0_PG)
+    {
+        /* The prefetch cache is indexed by linear addresses */
+        Fast486FlushCodeCache(State);
+    }
+    else
+    {
+        Fast486InvalidateCodeCache(State, Address, Size);
+    }
+#else
+    UNREFERENCED_PARAMETER(State);
+    UNREFERENCED_PARAMETER(Address);
+    UNREFERENCED_PARAMETER(Size);
 #endif
 }
 
@@ -4142,7 +4142,7 @@ FAST486_OPCODE_HANDLER(Fast486OpcodeLdsLes)
 
 #ifndef FAST486_NO_PREFETCH
             /* Invalidate the prefetch since BOP handlers can alter the memory */
-            State->PrefetchValid = FALSE;
+            Fast486FlushCodeCache(State);
 #endif
 
             /* Call the BOP handler */
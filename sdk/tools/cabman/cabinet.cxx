@@ -18,6 +18,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <atomic>
+#include <new>
+#include <thread>
 #if !defined(_WIN32)
 # include <dirent.h>
 # include <sys/stat.h>
@@ -97,6 +100,13 @@ CCabinet::CCabinet()
     BytesLeftInBlock = 0;
     ReuseBlock       = false;
     CurrentDataNode  = NULL;
+
+    WorkerCount = std::thread::hardware_concurrency();
+    if (WorkerCount == 0)
+        WorkerCount = 1;
+    else if (WorkerCount > CAB_MAX_WORKERS)
+        WorkerCount = CAB_MAX_WORKERS;
+    PendingCount = 0;
 }
 
 
@@ -114,6 +124,8 @@ CCabinet::~CCabinet()
 
     if (CodecSelected)
         delete Codec;
+
+    DestroyPendingBlocks();
 }
 
 bool CCabinet::IsSeparator(char Char)
@@ -1027,6 +1039,10 @@ void CCabinet::SelectCodec(LONG Id)
         if (Id == CodecId)
             return;
 
+        /* The queued data blocks and the codecs of the compressing threads use the old codec */
+        FlushDataBlocks();
+        DestroyPendingBlocks();
+
         CodecSelected = false;
         delete Codec;
     }
@@ -1156,8 +1172,15 @@ ULONG CCabinet::NewFolder()
  *     Status of operation
  */
 {
+    ULONG Status;
+
     DPRINT(MAX_TRACE, ("Creating new folder.\n"));
 
+    /* The queued data blocks belong to the current folder */
+    Status = FlushDataBlocks();
+    if (Status != CAB_STATUS_SUCCESS)
+        return Status;
+
     CurrentFolderNode = NewFolderNode();
     if (!CurrentFolderNode)
     {
@@ -1401,6 +1424,11 @@ ULONG CCabinet::CommitDisk(ULONG MoreDisks)
 {
     ULONG Status;
 
+    /* Write the data blocks still queued to the scratch file */
+    Status = FlushDataBlocks();
+    if (Status != CAB_STATUS_SUCCESS)
+        return Status;
+
     OnCabinetName(CurrentDiskNumber, CabinetName);
 
     /* Create file, fail if it already exists */
@@ -1487,6 +1515,8 @@ ULONG CCabinet::CloseCabinet()
 
     DestroyFolderNodes();
 
+    DestroyPendingBlocks();
+
     if (InputBuffer)
     {
         free(InputBuffer);
@@ -2756,11 +2786,21 @@ ULONG CCabinet::WriteDataBlock()
  */
 {
     ULONG Status;
-    ULONG BytesWritten;
-    PCFDATA_NODE DataNode;
 
     if (!BlockIsSplit)
     {
+        /*
+         * Without a disk size limit, the compressed size of a block is not
+         * needed before the next one is read. The block can then be queued
+         * and compressed together with the following ones.
+         */
+        if ((MaxDiskSize == 0) && (WorkerCount > 1) && (CodecId == CAB_CODEC_MSZIP))
+            return QueueDataBlock();
+
+        Status = FlushDataBlocks();
+        if (Status != CAB_STATUS_SUCCESS)
+            return Status;
+
         Status = Codec->Compress(OutputBuffer,
             InputBuffer,
             CurrentIBufferSize,
@@ -2773,6 +2813,21 @@ ULONG CCabinet::WriteDataBlock()
         CurrentOBufferSize = TotalCompSize;
     }
 
+    return WriteCompressedBlock();
+}
+
+
+ULONG CCabinet::WriteCompressedBlock()
+/*
+ * FUNCTION: Writes the compressed current data block to the scratch file
+ * RETURNS:
+ *     Status of operation
+ */
+{
+    ULONG Status;
+    ULONG BytesWritten;
+    PCFDATA_NODE DataNode;
+
     DataNode = NewDataNode(CurrentFolderNode);
     if (!DataNode)
     {
@@ -2835,6 +2890,137 @@ ULONG CCabinet::WriteDataBlock()
     return CAB_STATUS_SUCCESS;
 }
 
+
+ULONG CCabinet::QueueDataBlock()
+/*
+ * FUNCTION: Queues the current data block for compression
+ * RETURNS:
+ *     Status of operation
+ */
+{
+    PCFDATA_PENDING Block;
+
+    if (PendingCount == PendingBlocks.size())
+    {
+        Block = new (std::nothrow) CFDATA_PENDING;
+        if (!Block)
+        {
+            DPRINT(MIN_TRACE, ("Insufficient memory.\n"));
+            return CAB_STATUS_NOMEMORY;
+        }
+        PendingBlocks.push_back(Block);
+    }
+
+    Block = PendingBlocks[PendingCount++];
+    memcpy(Block->InputBuffer, InputBuffer, CurrentIBufferSize);
+    Block->InputSize = CurrentIBufferSize;
+
+    CurrentIBufferSize = 0;
+    CurrentIBuffer     = InputBuffer;
+
+    if (PendingCount < WorkerCount * CAB_PENDING_BLOCKS)
+        return CAB_STATUS_SUCCESS;
+
+    return FlushDataBlocks();
+}
+
+
+ULONG CCabinet::FlushDataBlocks()
+/*
+ * FUNCTION: Compresses the queued data blocks and writes them to the scratch file
+ * RETURNS:
+ *     Status of operation
+ */
+{
+    std::vector<std::thread> Threads;
+    std::atomic<ULONG> NextBlock(0);
+    void* SavedIBuffer;
+    ULONG SavedIBufferSize;
+    ULONG Status = CAB_STATUS_SUCCESS;
+    ULONG i;
+
+    if (PendingCount == 0)
+        return CAB_STATUS_SUCCESS;
+
+    /* Each block is a deflate stream of its own, they can be compressed in any order */
+    auto CompressBlocks = [this, &NextBlock](CCABCodec* BlockCodec)
+    {
+        PCFDATA_PENDING Block;
+        ULONG Index;
+
+        while ((Index = NextBlock++) < PendingCount)
+        {
+            Block = PendingBlocks[Index];
+            BlockCodec->Compress(Block->OutputBuffer,
+                Block->InputBuffer,
+                Block->InputSize,
+                &Block->OutputSize);
+        }
+    };
+
+    try
+    {
+        while (WorkerCodecs.size() < WorkerCount - 1)
+            WorkerCodecs.push_back(new CMSZipCodec());
+
+        Threads.reserve(WorkerCodecs.size());
+        for (i = 0; (i < WorkerCodecs.size()) && (i + 1 < PendingCount); i++)
+            Threads.emplace_back(CompressBlocks, WorkerCodecs[i]);
+    }
+    catch (...)
+    {
+        /* The threads already started and this one compress the blocks anyway */
+        DPRINT(MIN_TRACE, ("Cannot start a compressing thread.\n"));
+    }
+
+    CompressBlocks(Codec);
+
+    for (std::thread& Thread : Threads)
+        Thread.join();
+
+    /* Write the blocks in their original order */
+    SavedIBuffer     = CurrentIBuffer;
+    SavedIBufferSize = CurrentIBufferSize;
+
+    for (i = 0; i < PendingCount; i++)
+    {
+        DPRINT(MAX_TRACE, ("Block compressed. InputSize (%u)  OutputSize (%u).\n",
+            (UINT)PendingBlocks[i]->InputSize, (UINT)PendingBlocks[i]->OutputSize));
+
+        CurrentIBufferSize = PendingBlocks[i]->InputSize;
+        TotalCompSize      = PendingBlocks[i]->OutputSize;
+        CurrentOBuffer     = PendingBlocks[i]->OutputBuffer;
+        CurrentOBufferSize = PendingBlocks[i]->OutputSize;
+
+        Status = WriteCompressedBlock();
+        if (Status != CAB_STATUS_SUCCESS)
+            break;
+    }
+
+    PendingCount = 0;
+
+    CurrentIBuffer     = SavedIBuffer;
+    CurrentIBufferSize = SavedIBufferSize;
+
+    return Status;
+}
+
+
+void CCabinet::DestroyPendingBlocks()
+/*
+ * FUNCTION: Destroys the queued data blocks and the codecs of the compressing threads
+ */
+{
+    for (PCFDATA_PENDING Block : PendingBlocks)
+        delete Block;
+    PendingBlocks.clear();
+    PendingCount = 0;
+
+    for (CCABCodec* WorkerCodec : WorkerCodecs)
+        delete WorkerCodec;
+    WorkerCodecs.clear();
+}
+
 #if !defined(_WIN32)
 
 void CCabinet::ConvertDateAndTime(time_t* Time,
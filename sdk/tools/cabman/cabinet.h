@@ -27,6 +27,7 @@
 #include <limits.h>
 #include <string>
 #include <list>
+#include <vector>
 
 #ifndef PATH_MAX
 #define PATH_MAX MAX_PATH
@@ -108,6 +109,8 @@ extern ULONG DebugTraceLevel;
 #define CAB_SIGNATURE        0x4643534D // "MSCF"
 #define CAB_VERSION          0x0103
 #define CAB_BLOCKSIZE        32768
+#define CAB_MAX_WORKERS      16     // Maximum number of threads compressing data blocks
+#define CAB_PENDING_BLOCKS   4      // Data blocks queued per compressing thread
 
 #define CAB_COMP_MASK        0x00FF
 #define CAB_COMP_NONE        0x0000
@@ -211,6 +214,14 @@ typedef struct _CFDATA_NODE
     CFDATA      Data = { 0 };
 } CFDATA_NODE, *PCFDATA_NODE;
 
+typedef struct _CFDATA_PENDING
+{
+    ULONG           InputSize = 0;
+    ULONG           OutputSize = 0;
+    unsigned char   InputBuffer[CAB_BLOCKSIZE + 12];
+    unsigned char   OutputBuffer[CAB_BLOCKSIZE + 12];
+} CFDATA_PENDING, *PCFDATA_PENDING;
+
 typedef struct _CFFOLDER_NODE
 {
     ULONG           UncompOffset = 0;       // File size accumulator
@@ -422,6 +433,10 @@ private:
     ULONG WriteFileEntries();
     ULONG CommitDataBlocks(PCFFOLDER_NODE FolderNode);
     ULONG WriteDataBlock();
+    ULONG WriteCompressedBlock();
+    ULONG QueueDataBlock();
+    ULONG FlushDataBlocks();
+    void DestroyPendingBlocks();
     ULONG GetAttributesOnFile(PCFFILE_NODE File);
     ULONG SetAttributesOnFile(char* FileName, USHORT FileAttributes);
     ULONG GetFileTimes(FILE* FileHandle, PCFFILE_NODE File);
@@ -484,6 +499,10 @@ private:
     ULONG TotalBytesLeft;
     bool BlockIsSplit;                  // true if current data block is split
     ULONG NextFolderNumber;     // Zero based folder number
+    ULONG WorkerCount;          // Number of threads compressing data blocks
+    std::vector<CCABCodec*> WorkerCodecs;       // Codecs of the threads other than the main one
+    std::vector<PCFDATA_PENDING> PendingBlocks; // Data blocks waiting to be compressed
+    ULONG PendingCount;         // Number of data blocks queued
 #endif /* CAB_READ_ONLY */
 };
 
@@ -34,7 +34,12 @@ public:
                              PULONG OutputLength) override;
 private:
     int Status;
-    z_stream ZStream; /* Zlib stream */
+    /* The streams are kept over all blocks and only reset between them,
+       instead of allocating and initializing the zlib state for each block */
+    z_stream DeflateStream;
+    z_stream InflateStream;
+    bool DeflateInitialized;
+    bool InflateInitialized;
 };
 
 /* EOF */
@@ -265,8 +265,16 @@ CsrpCheckRequestThreads(VOID)
     /* Decrease the count, and see if we're out */
     if (InterlockedDecrementUL(&CsrpStaticThreadCount) == 0)
     {
-        /* Check if we've still got space for a Dynamic Thread */
-        if (CsrpDynamicThreadTotal < CsrMaxApiRequestThreads)
+        /*
+         * Reserve a Dynamic Thread slot up-front, so that concurrent request
+         * threads running dry at the same time cannot overshoot the limit.
+         */
+        if (InterlockedIncrementUL(&CsrpDynamicThreadTotal) > CsrMaxApiRequestThreads)
+        {
+            /* We're at the limit already, give the slot back */
+            InterlockedDecrementUL(&CsrpDynamicThreadTotal);
+        }
+        else
         {
             /* Create a new dynamic thread */
             Status = RtlCreateUserThread(NtCurrentProcess(),
@@ -282,9 +290,8 @@ CsrpCheckRequestThreads(VOID)
             /* Check success */
             if (NT_SUCCESS(Status))
             {
-                /* Increase the thread counts */
+                /* Increase the free thread count */
                 InterlockedIncrementUL(&CsrpStaticThreadCount);
-                InterlockedIncrementUL(&CsrpDynamicThreadTotal);
 
                 /* Add a new server thread */
                 if (CsrAddStaticServerThread(hThread,
@@ -309,6 +316,11 @@ CsrpCheckRequestThreads(VOID)
                     return STATUS_UNSUCCESSFUL;
                 }
             }
+            else
+            {
+                /* Couldn't create it, release the slot we reserved */
+                InterlockedDecrementUL(&CsrpDynamicThreadTotal);
+            }
         }
     }
 
@@ -567,7 +567,12 @@ CsrParseServerCommandLine(IN ULONG ArgumentCount,
     CsrWindowsControl = FALSE;
     CsrSubSystemType = IMAGE_SUBSYSTEM_UNKNOWN;
 #endif
-    CsrMaxApiRequestThreads = 16;
+    /*
+     * Allow more API threads on bigger machines, so that logon storms on
+     * multi-processor servers don't queue up behind a few busy threads.
+     * "MaxRequestThreads" on the command line still overrides this.
+     */
+    CsrMaxApiRequestThreads = max(16, 4 * CsrNtSysInfo.NumberOfProcessors);
 
     /* Save our Session ID, and create a Directory for it */
     SessionId = NtCurrentPeb()->SessionId;
@@ -39,6 +39,9 @@
 FAST486_STATE EmulatorContext;
 BOOLEAN CpuRunning = FALSE;
 
+/* Code cache of the CPU, kept out of its state */
+static FAST486_CACHE_LINE CodeCache[FAST486_CACHE_LINES];
+
 /* No more than 'MaxCpuCallLevel' recursive CPU calls are allowed */
 static const INT MaxCpuCallLevel = 32;
 static INT CpuCallLevel = 0; // == 0: CPU stopped; >= 1: CPU running or halted
@@ -233,6 +236,12 @@ BOOLEAN CpuInitialize(VOID)
                       EmulatorFpu,
                       NULL /* TODO: Use a TLB */);
 
+    /* Let the CPU access the unhooked memory directly */
+    Fast486SetMemoryMap(&EmulatorContext, MemGetMemoryMap(), TOTAL_PAGES);
+
+    /* Keep the recently executed code lines */
+    Fast486SetCodeCache(&EmulatorContext, CodeCache, ARRAYSIZE(CodeCache));
+
     /* Initialize the software callback system and register the emulator BOPs */
     // RegisterBop(BOP_DEBUGGER  , EmulatorDebugBreakBop);
     RegisterBop(BOP_UNSIMULATE, CpuUnsimulateBop);
@@ -375,6 +375,16 @@ ReadDisk(IN PDISK_IMAGE DiskImage,
 
     BytesToRead = (DWORD)NumSectors * DiskImage->DiskInfo.SectorSize;
 
+    /* If the destination is plain guest RAM, read the sectors straight into it */
+    LocalBuffer = MemGetDirectAccess(TO_LINEAR(getES(), getBX()), BytesToRead);
+    if (LocalBuffer)
+    {
+        if (!ReadFile(DiskImage->hDisk, LocalBuffer, BytesToRead, &BytesToRead, NULL))
+            return 0x04;
+
+        return 0x00;
+    }
+
     // FIXME: Consider just looping around filling each time the buffer...
 
     if (BytesToRead <= sizeof(StaticBuffer))
@@ -436,6 +446,16 @@ WriteDisk(IN PDISK_IMAGE DiskImage,
 
     BytesToWrite = (DWORD)NumSectors * DiskImage->DiskInfo.SectorSize;
 
+    /* If the source is plain guest RAM, write the sectors straight from it */
+    LocalBuffer = MemGetDirectAccess(TO_LINEAR(getES(), getBX()), BytesToWrite);
+    if (LocalBuffer)
+    {
+        if (!WriteFile(DiskImage->hDisk, LocalBuffer, BytesToWrite, &BytesToWrite, NULL))
+            return 0x04;
+
+        return 0x00;
+    }
+
     // FIXME: Consider just looping around filling each time the buffer...
 
     if (BytesToWrite <= sizeof(StaticBuffer))
@@ -397,6 +397,7 @@ DWORD DmaRequest(IN WORD      iChannel,
     DWORD i, Size, ret = 0;
     BYTE RegMode, OpMode, Increment, Autoinit, TrMode;
     PBYTE dmabuf = Buffer;
+    PBYTE Direct;
 
     ULONG CurrAddress;
 
@@ -411,7 +412,7 @@ DWORD DmaRequest(IN WORD      iChannel,
 
     RegMode = pDcp->DmaChannel[Channel].Mode;
 
-    DPRINT1("DMA_Command = %x length=%d\n", RegMode, length);
+    DPRINT("DMA_Command = %x length=%d\n", RegMode, length);
 
     /* Exit if the controller is disabled or the channel is masked */
     if ((pDcp->Command & 0x04) || (pDcp->Mask & (1 << Channel)))
@@ -474,13 +475,21 @@ DWORD DmaRequest(IN WORD      iChannel,
         /* Write */
         case 1:
         {
-            DPRINT1("Perform Write transfer of %d elements (%d bytes) at 0x%x %s with count %x\n",
+            DPRINT("Perform Write transfer of %d elements (%d bytes) at 0x%x %s with count %x\n",
                     ret, length, CurrAddress, Increment ? "up" : "down", pDcp->DmaChannel[Channel].CurrElemCnt);
 
             if (Increment)
             {
                 EmulatorWriteMemory(&EmulatorContext, CurrAddress, dmabuf, length);
             }
+            else if ((Direct = MemGetDirectAccess(CurrAddress - length + 1, length)) != NULL)
+            {
+                /* Plain guest RAM: store the bytes backwards in one pass */
+                for (i = 0; i < length; i++)
+                {
+                    Direct[length - 1 - i] = dmabuf[i];
+                }
+            }
             else
             {
                 for (i = 0; i < length; i++)
@@ -489,19 +498,32 @@ DWORD DmaRequest(IN WORD      iChannel,
                 }
             }
 
+            /* The CPU may have cached code from the memory we just wrote */
+            Fast486InvalidateCache(&EmulatorContext,
+                                   Increment ? CurrAddress : CurrAddress - length + 1,
+                                   length);
+
             break;
         }
 
         /* Read */
         case 2:
         {
-            DPRINT1("Perform Read transfer of %d elements (%d bytes) at 0x%x %s with count %x\n",
+            DPRINT("Perform Read transfer of %d elements (%d bytes) at 0x%x %s with count %x\n",
                     ret, length, CurrAddress, Increment ? "up" : "down", pDcp->DmaChannel[Channel].CurrElemCnt);
 
             if (Increment)
             {
                 EmulatorReadMemory(&EmulatorContext, CurrAddress, dmabuf, length);
             }
+            else if ((Direct = MemGetDirectAccess(CurrAddress - length + 1, length)) != NULL)
+            {
+                /* Plain guest RAM: fetch the bytes backwards in one pass */
+                for (i = 0; i < length; i++)
+                {
+                    dmabuf[i] = Direct[length - 1 - i];
+                }
+            }
             else
             {
                 for (i = 0; i < length; i++)
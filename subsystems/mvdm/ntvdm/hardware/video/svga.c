@@ -1984,6 +1984,8 @@ BOOLEAN FASTCALL VgaWriteMemory(ULONG Address, PVOID Buffer, ULONG Size)
     DWORD i, j;
     DWORD VideoAddress;
     PUCHAR BufPtr = (PUCHAR)Buffer;
+    BYTE PlaneMask, Planes;
+    BOOLEAN Chain4, OddEven;
 
     DPRINT("VgaWriteMemory: Address 0x%08X, Size %lu\n", Address, Size);
 
@@ -1991,39 +1993,34 @@ BOOLEAN FASTCALL VgaWriteMemory(ULONG Address, PVOID Buffer, ULONG Size)
     if ((VgaMiscRegister & VGA_MISC_RAM_ENABLED) == 0) return TRUE;
 
     /* Also ignore if write access to all planes is disabled */
-    if ((VgaSeqRegisters[VGA_SEQ_MASK_REG] & 0x0F) == 0x00) return TRUE;
+    PlaneMask = VgaSeqRegisters[VGA_SEQ_MASK_REG] & 0x0F;
+    if (PlaneMask == 0x00) return TRUE;
 
     if (!(VgaSeqRegisters[SVGA_SEQ_EXT_MODE_REG] & SVGA_SEQ_EXT_MODE_HIGH_RES))
     {
+        /*
+         * The memory mode cannot change during the write, so decode
+         * it once for the whole buffer instead of once per byte
+         */
+        Chain4  = !!(VgaSeqRegisters[VGA_SEQ_MEM_REG] & VGA_SEQ_MEM_C4);
+        OddEven = !!(VgaGcRegisters[VGA_GC_MODE_REG] & VGA_GC_MODE_OE);
+
         /* Loop through each byte */
         for (i = 0; i < Size; i++)
         {
             VideoAddress = VgaTranslateAddress(Address + i);
+            Planes = PlaneMask;
 
-            for (j = 0; j < VGA_NUM_BANKS; j++)
-            {
-                /* Make sure the page is writeable */
-                if (!(VgaSeqRegisters[VGA_SEQ_MASK_REG] & (1 << j))) continue;
+            /* Check if this is chain-4 mode */
+            if (Chain4) Planes &= 1 << ((Address + i) & 0x03);
 
-                /* Check if this is chain-4 mode */
-                if (VgaSeqRegisters[VGA_SEQ_MEM_REG] & VGA_SEQ_MEM_C4)
-                {
-                    if (((Address + i) & 0x03) != j)
-                    {
-                        /* This plane will not be accessed */
-                        continue;
-                    }
-                }
+            /* Check if this is odd-even mode */
+            if (OddEven) Planes &= ((Address + i) & 0x01) ? 0x0A : 0x05;
 
-                /* Check if this is odd-even mode */
-                if (VgaGcRegisters[VGA_GC_MODE_REG] & VGA_GC_MODE_OE)
-                {
-                    if (((Address + i) & 0x01) != (j & 1))
-                    {
-                        /* This plane will not be accessed */
-                        continue;
-                    }
-                }
+            for (j = 0; j < VGA_NUM_BANKS; j++)
+            {
+                /* Make sure the plane is accessed */
+                if (!(Planes & (1 << j))) continue;
 
                 /* Copy the value to the VGA memory */
                 VgaMemory[VideoAddress * VGA_NUM_BANKS + j] = VgaTranslateByteForWriting(BufPtr[i], j);
@@ -41,6 +41,7 @@ typedef struct _MEM_HOOK
 
 static LIST_ENTRY HookList;
 static PMEM_HOOK PageTable[TOTAL_PAGES] = { NULL };
+static PUCHAR MemoryMap[TOTAL_PAGES] = { NULL };
 static BOOLEAN A20Line = FALSE;
 
 /* PRIVATE FUNCTIONS **********************************************************/
@@ -137,6 +138,25 @@ WritePage(PMEM_HOOK Hook, ULONG Address, PVOID Buffer, ULONG Size)
     }
 }
 
+static VOID
+MemUpdateMemoryMap(VOID)
+{
+    ULONG i, Page;
+
+    /*
+     * Give the CPU direct access to every page that is not hooked.
+     * This must be called each time a hook is installed or removed,
+     * and when the A20 line is toggled.
+     */
+    for (i = 0; i < TOTAL_PAGES; i++)
+    {
+        /* If the A20 line is disabled, mask bit 20 */
+        Page = A20Line ? i : (i & ~((1 << 20) >> 12));
+
+        MemoryMap[i] = (PageTable[Page] == NULL) ? (PUCHAR)REAL_TO_PHYS(Page << 12) : NULL;
+    }
+}
+
 /* PUBLIC FUNCTIONS ***********************************************************/
 
 VOID FASTCALL EmulatorReadMemory(PFAST486_STATE State, ULONG Address, PVOID Buffer, ULONG Size)
@@ -274,7 +294,11 @@ VOID FASTCALL EmulatorCopyMemory(PFAST486_STATE State, ULONG DestAddress, ULONG
 
 VOID EmulatorSetA20(BOOLEAN Enabled)
 {
+    /* Toggling the A20 line changes the memory seen above 1 MB */
+    if (A20Line != Enabled) Fast486FlushCache(&EmulatorContext);
+
     A20Line = Enabled;
+    MemUpdateMemoryMap();
 }
 
 BOOLEAN EmulatorGetA20(VOID)
@@ -282,6 +306,38 @@ BOOLEAN EmulatorGetA20(VOID)
     return A20Line;
 }
 
+PUCHAR *MemGetMemoryMap(VOID)
+{
+    return MemoryMap;
+}
+
+PVOID MemGetDirectAccess(ULONG Address, ULONG Size)
+{
+    ULONG i, FirstPage, LastPage;
+    PUCHAR Base;
+
+    /*
+     * Return a host pointer to the guest range, if it only spans
+     * unhooked pages that are also contiguous on the host side.
+     */
+    if (Size == 0 || Address >= MAX_ADDRESS || Size > MAX_ADDRESS - Address)
+        return NULL;
+
+    FirstPage = Address >> 12;
+    LastPage  = (Address + Size - 1) >> 12;
+
+    Base = MemoryMap[FirstPage];
+    if (Base == NULL) return NULL;
+
+    for (i = FirstPage + 1; i <= LastPage; i++)
+    {
+        /* The A20 wrap-around also breaks the host contiguity */
+        if (MemoryMap[i] != Base + ((i - FirstPage) << 12)) return NULL;
+    }
+
+    return Base + (Address & (PAGE_SIZE - 1));
+}
+
 VOID
 MemExceptionHandler(ULONG FaultAddress, BOOLEAN Writing)
 {
@@ -346,6 +402,7 @@ MemInstallFastMemoryHook(PVOID Address,
     /* Add the hook entry to the page table */
     for (i = FirstPage; i <= LastPage; i++) PageTable[i] = Hook;
 
+    MemUpdateMemoryMap();
     return TRUE;
 }
 
@@ -374,6 +431,7 @@ MemRemoveFastMemoryHook(PVOID Address, ULONG Size)
         PageTable[i] = NULL;
     }
 
+    MemUpdateMemoryMap();
     return TRUE;
 }
 
@@ -542,6 +600,7 @@ VDDInstallMemoryHook(IN HANDLE hVdd,
     /* Add the hook entry to the page table */
     for (i = FirstPage; i <= LastPage; i++) PageTable[i] = Hook;
 
+    MemUpdateMemoryMap();
     return TRUE;
 }
 
@@ -598,6 +657,7 @@ VDDDeInstallMemoryHook(IN HANDLE hVdd,
         PageTable[i] = NULL;
     }
 
+    MemUpdateMemoryMap();
     return TRUE;
 }
 
@@ -776,6 +836,9 @@ MemInitialize(VOID)
      * retrieve the exact CS:IP where the problem happens.
      */
     RtlFillMemory(BaseAddress, MAX_ADDRESS, 0xCC);
+
+    /* Nothing is hooked yet */
+    MemUpdateMemoryMap();
     return TRUE;
 }
 
@@ -67,6 +67,8 @@ EmulatorCopyMemory
 
 VOID EmulatorSetA20(BOOLEAN Enabled);
 BOOLEAN EmulatorGetA20(VOID);
+PUCHAR *MemGetMemoryMap(VOID);
+PVOID MemGetDirectAccess(ULONG Address, ULONG Size);
 
 BOOL
 MemInstallFastMemoryHook
@@ -34,6 +34,13 @@ do { \
     MultiByteToWideChar((Console)->OutputCodePage, 0, (sChar), 1, (dWChar), 1); \
 } while (0)
 
+/*
+ * Size (in characters) of the on-stack buffer used to convert ANSI strings
+ * written with WriteConsoleA. Most console writes are single lines, which
+ * then avoid a heap round-trip and a second conversion pass.
+ */
+#define WRITE_CONSOLE_STACK_CHARS   256
+
 /* PRIVATE FUNCTIONS **********************************************************/
 
 /*static*/ VOID
@@ -147,18 +154,24 @@ ConioCoordToPointer(PTEXTMODE_SCREEN_BUFFER Buff, ULONG X, ULONG Y)
     return &Buff->Buffer[((Y + Buff->VirtualY) % Buff->ScreenBufferSize.Y) * Buff->ScreenBufferSize.X + X];
 }
 
+static __inline VOID
+ConioFillCells(PCHAR_INFO Ptr, ULONG Count, CHAR_INFO FillChar)
+{
+    /* Fill a run of contiguous cells, which all lie on the same line */
+    while (Count--)
+        *Ptr++ = FillChar;
+}
+
 /*static*/ VOID
 ClearLineBuffer(PTEXTMODE_SCREEN_BUFFER Buff)
 {
-    PCHAR_INFO Ptr = ConioCoordToPointer(Buff, 0, Buff->CursorPosition.Y);
-    SHORT Pos;
+    CHAR_INFO FillChar;
 
-    for (Pos = 0; Pos < Buff->ScreenBufferSize.X; Pos++, Ptr++)
-    {
-        /* Fill the cell */
-        Ptr->Char.UnicodeChar = L' ';
-        Ptr->Attributes = Buff->ScreenDefaultAttrib;
-    }
+    FillChar.Char.UnicodeChar = L' ';
+    FillChar.Attributes = Buff->ScreenDefaultAttrib;
+
+    ConioFillCells(ConioCoordToPointer(Buff, 0, Buff->CursorPosition.Y),
+                   Buff->ScreenBufferSize.X, FillChar);
 }
 
 static VOID
@@ -326,20 +339,27 @@ ConioFillRegion(
     for (Y = Region->Top; Y <= Region->Bottom; ++Y)
     {
         Ptr = ConioCoordToPointer(ScreenBuffer, Region->Left, Y);
-        for (X = Region->Left; X <= Region->Right; ++X)
+
+        // TODO: Correctly support filling with full-width characters.
+
+        if (!ExcludeRegion ||
+            Y < ExcludeRegion->Top || Y > ExcludeRegion->Bottom ||
+            Region->Right < ExcludeRegion->Left || Region->Left > ExcludeRegion->Right)
         {
-            // TODO: Correctly support filling with full-width characters.
+            /* The whole row is outside the excluded region, fill it */
+            ConioFillCells(Ptr, ConioRectWidth(Region), FillChar);
+            continue;
+        }
 
-            if (!ExcludeRegion ||
-                !(X >= ExcludeRegion->Left && X <= ExcludeRegion->Right &&
-                  Y >= ExcludeRegion->Top  && Y <= ExcludeRegion->Bottom))
-            {
-                /* We are outside the excluded region, fill the destination */
-                *Ptr = FillChar;
-                // Ptr->Attributes &= ~COMMON_LVB_SBCSDBCS;
-            }
+        /* Fill the parts of the row on the left and on the right of the excluded region */
+        X = max(Region->Left, ExcludeRegion->Left);
+        ConioFillCells(Ptr, X - Region->Left, FillChar);
 
-            ++Ptr;
+        X = min(Region->Right, ExcludeRegion->Right) + 1;
+        if (X <= Region->Right)
+        {
+            ConioFillCells(Ptr + (X - Region->Left),
+                           Region->Right - X + 1, FillChar);
         }
     }
 }
@@ -769,6 +789,7 @@ ConDrvWriteConsole(IN PCONSOLE Console,
 {
     NTSTATUS Status = STATUS_SUCCESS;
     PWCHAR Buffer = NULL;
+    WCHAR StackBuffer[WRITE_CONSOLE_STACK_CHARS];
     ULONG Written = 0;
     ULONG Length;
 
@@ -786,6 +807,19 @@ ConDrvWriteConsole(IN PCONSOLE Console,
     if (Unicode)
     {
         Buffer = StringBuffer;
+        Length = NumCharsToWrite;
+    }
+    else if (NumCharsToWrite <= ARRAYSIZE(StackBuffer))
+    {
+        /*
+         * A multi-byte string never converts to more UNICODE characters
+         * than it has bytes, so convert it directly on the stack.
+         */
+        Buffer = StackBuffer;
+        Length = MultiByteToWideChar(Console->OutputCodePage, 0,
+                                     (PCHAR)StringBuffer,
+                                     NumCharsToWrite,
+                                     Buffer, ARRAYSIZE(StackBuffer));
     }
     else
     {
@@ -815,7 +849,7 @@ ConDrvWriteConsole(IN PCONSOLE Console,
             Status = TermWriteStream(Console,
                                      ScreenBuffer,
                                      Buffer,
-                                     NumCharsToWrite,
+                                     Length,
                                      TRUE);
             if (NT_SUCCESS(Status))
             {
@@ -823,7 +857,8 @@ ConDrvWriteConsole(IN PCONSOLE Console,
             }
         }
 
-        if (!Unicode) ConsoleFreeHeap(Buffer);
+        if (Buffer != StringBuffer && Buffer != StackBuffer)
+            ConsoleFreeHeap(Buffer);
     }
 
     if (NumCharsWritten) *NumCharsWritten = Written;
@@ -1529,7 +1564,21 @@ ConDrvScrollConsoleScreenBuffer(
                   CapturedDestinationOrigin.Y + ConioRectHeight(&SrcRegion) - 1,
                   CapturedDestinationOrigin.X + ConioRectWidth(&SrcRegion ) - 1);
 
-    if (ConioGetIntersection(&DstRegion, &DstRegion, &CapturedClipRectangle))
+    /*
+     * Fast path: scrolling the whole screen buffer up without clipping only
+     * needs the circular line array to be rotated. The lines coming in at
+     * the bottom are exactly the ones that are filled below, as long as the
+     * source region starts within the upper half of the screen buffer.
+     */
+    if (CapturedDestinationOrigin.X == 0 && CapturedDestinationOrigin.Y == 0 &&
+        SrcRegion.Left == 0 && SrcRegion.Right  == Buffer->ScreenBufferSize.X - 1 &&
+        SrcRegion.Top  >  0 && SrcRegion.Bottom == Buffer->ScreenBufferSize.Y - 1 &&
+        SrcRegion.Top <= Buffer->ScreenBufferSize.Y / 2 &&
+        RtlEqualMemory(&CapturedClipRectangle, &ScreenBuffer, sizeof(SMALL_RECT)))
+    {
+        Buffer->VirtualY = (Buffer->VirtualY + SrcRegion.Top) % Buffer->ScreenBufferSize.Y;
+    }
+    else if (ConioGetIntersection(&DstRegion, &DstRegion, &CapturedClipRectangle))
     {
         /*
          * Build the region image, within the source region,
@@ -22,6 +22,9 @@
 
 #define IS_WHITESPACE(c)    ((c) == L'\0' || (c) == L' ' || (c) == L'\t')
 
+/* Maximum number of characters painted by a single text-out call */
+#define RUN_BUFFER_SIZE     256
+
 /* FUNCTIONS ******************************************************************/
 
 static COLORREF
@@ -485,30 +488,77 @@ GuiPaintTextModeBuffer(PTEXTMODE_SCREEN_BUFFER Buffer,
     {
         for (Line = TopLine; Line <= BottomLine; Line++)
         {
+            WCHAR LineBuffer[RUN_BUFFER_SIZE];  // Characters of the current run
+            INT   CellWidths[RUN_BUFFER_SIZE];  // Their advance widths, in pixels
+            ULONG Count = 0;
+
+            Start = LeftColumn;
+
             for (Char = LeftColumn; Char <= RightColumn; Char++)
             {
                 From = ConioCoordToPointer(Buffer, Char, Line);
                 Attribute = From->Attributes;
-                SetTextColor(GuiData->hMemDC, PaletteRGBFromAttrib(Console, TextAttribFromAttrib(Attribute)));
-                SetBkColor(GuiData->hMemDC, PaletteRGBFromAttrib(Console, BkgdAttribFromAttrib(Attribute)));
 
-                /* Change underline state if needed */
-                if (!!(Attribute & COMMON_LVB_UNDERSCORE) != IsUnderline)
+                /*
+                 * The trailing byte of a full-width character is drawn
+                 * together with its leading byte: just widen the latter.
+                 */
+                if (Attribute & COMMON_LVB_TRAILING_BYTE)
                 {
-                    IsUnderline = !!(Attribute & COMMON_LVB_UNDERSCORE);
+                    if (Count > 0)
+                        CellWidths[Count - 1] += GuiData->CharWidth;
+                    else
+                        Start = Char + 1;
+                    continue;
+                }
+
+                /*
+                 * We flush the run if the new attribute is different
+                 * from the current one, or if the buffer is full.
+                 */
+                if ((Attribute & ~COMMON_LVB_SBCSDBCS) != (LastAttribute & ~COMMON_LVB_SBCSDBCS) ||
+                    Count == ARRAYSIZE(LineBuffer))
+                {
+                    if (Count > 0)
+                    {
+                        ExtTextOutW(GuiData->hMemDC,
+                                    Start * GuiData->CharWidth,
+                                    Line  * GuiData->CharHeight,
+                                    0, NULL,
+                                    LineBuffer, Count, CellWidths);
+                    }
+                    Start = Char;
+                    Count = 0;
+
+                    if ((Attribute & ~COMMON_LVB_SBCSDBCS) != (LastAttribute & ~COMMON_LVB_SBCSDBCS))
+                    {
+                        SetTextColor(GuiData->hMemDC, PaletteRGBFromAttrib(Console, TextAttribFromAttrib(Attribute)));
+                        SetBkColor(GuiData->hMemDC, PaletteRGBFromAttrib(Console, BkgdAttribFromAttrib(Attribute)));
 
-                    /* Select the new font */
-                    NewFont = GuiData->Font[IsUnderline ? FONT_BOLD : FONT_NORMAL];
-                    SelectObject(GuiData->hMemDC, NewFont);
+                        /* Change underline state if needed */
+                        if (!!(Attribute & COMMON_LVB_UNDERSCORE) != IsUnderline)
+                        {
+                            IsUnderline = !!(Attribute & COMMON_LVB_UNDERSCORE);
+                            /* Select the new font */
+                            NewFont = GuiData->Font[IsUnderline ? FONT_BOLD : FONT_NORMAL];
+                            SelectObject(GuiData->hMemDC, NewFont);
+                        }
+                    }
+                    LastAttribute = Attribute;
                 }
 
-                if (Attribute & COMMON_LVB_TRAILING_BYTE)
-                    continue;
+                LineBuffer[Count] = From->Char.UnicodeChar;
+                CellWidths[Count] = GuiData->CharWidth;
+                Count++;
+            }
 
-                TextOutW(GuiData->hMemDC,
-                         Char * GuiData->CharWidth,
-                         Line * GuiData->CharHeight,
-                         &From->Char.UnicodeChar, 1);
+            if (Count > 0)
+            {
+                ExtTextOutW(GuiData->hMemDC,
+                            Start * GuiData->CharWidth,
+                            Line  * GuiData->CharHeight,
+                            0, NULL,
+                            LineBuffer, Count, CellWidths);
             }
         }
     }
@@ -516,7 +566,7 @@ GuiPaintTextModeBuffer(PTEXTMODE_SCREEN_BUFFER Buffer,
     {
         for (Line = TopLine; Line <= BottomLine; Line++)
         {
-            WCHAR LineBuffer[80];   // Buffer containing a part or all the line to be displayed
+            WCHAR LineBuffer[RUN_BUFFER_SIZE];  // Buffer containing a part or all the line to be displayed
             From  = ConioCoordToPointer(Buffer, LeftColumn, Line);  // Get the first code of the line
             Start = LeftColumn;
             To    = LineBuffer;
@@ -527,7 +577,7 @@ GuiPaintTextModeBuffer(PTEXTMODE_SCREEN_BUFFER Buffer,
                  * We flush the buffer if the new attribute is different
                  * from the current one, or if the buffer is full.
                  */
-                if (From->Attributes != LastAttribute || (Char - Start == sizeof(LineBuffer) / sizeof(WCHAR)))
+                if (From->Attributes != LastAttribute || (Char - Start == ARRAYSIZE(LineBuffer)))
                 {
                     TextOutW(GuiData->hMemDC,
                              Start * GuiData->CharWidth,